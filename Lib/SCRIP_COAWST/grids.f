@@ -161,6 +161,33 @@
                          ! min,max latitude for each search bin
      &,       bin_lons   ! min,max longitude for each search bin
 
+!-----------------------------------------------------------------------
+!
+!     cell index for restricting searches.  each grid is covered by a
+!     uniform lat/lon mesh of buckets, and each bucket lists (in 
+!     address order) the cells whose bounding box overlaps it.
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind), parameter ::                             &
+     &        cells_per_bucket = 4  ! average cells in each bucket
+
+      type cell_index
+        integer (kind=int_kind) ::                                      &
+     &        nlat, nlon       ! number of buckets in lat, lon
+        real (kind=dbl_kind) ::                                         &
+     &        lat0, lon0,                                               &
+                               ! lat/lon of sw corner of bucket mesh
+     &        dlat, dlon       ! lat/lon size of each bucket
+        integer (kind=int_kind), dimension(:), allocatable ::           &
+     &        bkt_start,                                                &
+                               ! first entry in bkt_cells of each bucket
+     &        bkt_cells        ! cell addresses sorted by bucket
+      end type cell_index
+
+      type (cell_index), save ::                                        &
+     &        grid1_index, grid2_index  ! cell index for each grid
+
 !***********************************************************************
 
       contains
@@ -571,6 +598,15 @@
       where (grid2_center_lat < grid2_bound_box(1,:))                   &
      &  grid2_bound_box(1,:) = -pih
 
+!-----------------------------------------------------------------------
+!
+!     build cell index of each grid for restricting searches
+!
+!-----------------------------------------------------------------------
+
+      call index_init(grid1_index, grid1_bound_box)
+      call index_init(grid2_index, grid2_bound_box)
+
 !-----------------------------------------------------------------------
 !
 !     set up and assign address ranges to search bins in order to 
@@ -682,4 +718,337 @@
 
       end subroutine grid_init_coawst
 
+!***********************************************************************
+
+      subroutine index_init(cindex, bound_box)
+
+!-----------------------------------------------------------------------
+!
+!     this routine builds the cell index of a grid from the bounding
+!     boxes of its cells.
+!
+!-----------------------------------------------------------------------
+
+      type (cell_index), intent(inout) ::                               &
+     &        cindex            ! cell index to build
+
+      real (kind=dbl_kind), dimension(:,:), intent(in) ::               &
+     &        bound_box         ! bounding box of each cell
+
+!-----------------------------------------------------------------------
+!
+!     local variables
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind) ::                                        &
+     &        ncells, nbkt, cell, n, i, j,                              &
+     &        ilat1, ilat2, ilon1, ilon2
+
+      integer (kind=int_kind), dimension(:), allocatable ::             &
+     &        next_entry        ! next free entry in each bucket
+
+      real (kind=dbl_kind) ::                                           &
+     &        lat_range, lon_range
+
+!-----------------------------------------------------------------------
+!
+!     size the bucket mesh so that buckets are about square and hold
+!     cells_per_bucket cells on average
+!
+!-----------------------------------------------------------------------
+
+      ncells = size(bound_box,DIM=2)
+
+      cindex%lat0 = minval(bound_box(1,:))
+      cindex%lon0 = minval(bound_box(3,:))
+      lat_range = max(maxval(bound_box(2,:)) - cindex%lat0, tiny)
+      lon_range = max(maxval(bound_box(4,:)) - cindex%lon0, tiny)
+
+      nbkt = max(1, ncells/cells_per_bucket)
+      cindex%nlat = max(1, nint(sqrt(nbkt*lat_range/lon_range)))
+      cindex%nlat = min(cindex%nlat, nbkt)
+      cindex%nlon = max(1, nbkt/cindex%nlat)
+      cindex%dlat = lat_range/cindex%nlat
+      cindex%dlon = lon_range/cindex%nlon
+
+      if (allocated(cindex%bkt_start)) deallocate(cindex%bkt_start)
+      if (allocated(cindex%bkt_cells)) deallocate(cindex%bkt_cells)
+      allocate(cindex%bkt_start(cindex%nlat*cindex%nlon+1))
+
+!-----------------------------------------------------------------------
+!
+!     count the cells in each bucket, then fill the buckets.  cells
+!     are visited in address order so each bucket is sorted.
+!
+!-----------------------------------------------------------------------
+
+      cindex%bkt_start = 0
+      do cell=1,ncells
+        call index_range(cindex, bound_box(:,cell),                     &
+     &                   ilat1, ilat2, ilon1, ilon2)
+        do j=ilat1,ilat2
+        do i=ilon1,ilon2
+          n = (j-1)*cindex%nlon + i + 1
+          cindex%bkt_start(n) = cindex%bkt_start(n) + 1
+        end do
+        end do
+      end do
+
+      cindex%bkt_start(1) = 1
+      do n=2,cindex%nlat*cindex%nlon+1
+        cindex%bkt_start(n) = cindex%bkt_start(n) +                     &
+     &                        cindex%bkt_start(n-1)
+      end do
+
+      allocate(cindex%bkt_cells(cindex%bkt_start(                       &
+     &                          cindex%nlat*cindex%nlon+1)-1))
+      allocate(next_entry(cindex%nlat*cindex%nlon))
+      next_entry = cindex%bkt_start(1:cindex%nlat*cindex%nlon)
+
+      do cell=1,ncells
+        call index_range(cindex, bound_box(:,cell),                     &
+     &                   ilat1, ilat2, ilon1, ilon2)
+        do j=ilat1,ilat2
+        do i=ilon1,ilon2
+          n = (j-1)*cindex%nlon + i
+          cindex%bkt_cells(next_entry(n)) = cell
+          next_entry(n) = next_entry(n) + 1
+        end do
+        end do
+      end do
+
+      deallocate(next_entry)
+
+!-----------------------------------------------------------------------
+
+      end subroutine index_init
+
+!***********************************************************************
+
+      subroutine index_range(cindex, box, ilat1, ilat2, ilon1, ilon2)
+
+!-----------------------------------------------------------------------
+!
+!     this routine returns the range of buckets of a cell index that
+!     overlap a lat/lon box.
+!
+!-----------------------------------------------------------------------
+
+      type (cell_index), intent(in) ::                                  &
+     &        cindex            ! cell index
+
+      real (kind=dbl_kind), dimension(4), intent(in) ::                 &
+     &        box               ! min lat, max lat, min lon, max lon
+
+      integer (kind=int_kind), intent(out) ::                           &
+     &        ilat1, ilat2,                                             &
+                                ! range of buckets in lat
+     &        ilon1, ilon2      ! range of buckets in lon
+
+!-----------------------------------------------------------------------
+
+      ilat1 = index_bucket(box(1),cindex%lat0,cindex%dlat,cindex%nlat)
+      ilat2 = index_bucket(box(2),cindex%lat0,cindex%dlat,cindex%nlat)
+      ilon1 = index_bucket(box(3),cindex%lon0,cindex%dlon,cindex%nlon)
+      ilon2 = index_bucket(box(4),cindex%lon0,cindex%dlon,cindex%nlon)
+
+!-----------------------------------------------------------------------
+
+      end subroutine index_range
+
+!***********************************************************************
+
+      function index_bucket(coord, coord0, dcoord, nbkt)
+
+!-----------------------------------------------------------------------
+!
+!     this function returns the bucket containing a lat or lon,
+!     clipped to the bucket mesh.
+!
+!-----------------------------------------------------------------------
+
+      real (kind=dbl_kind), intent(in) ::                               &
+     &        coord, coord0, dcoord
+
+      integer (kind=int_kind), intent(in) ::                            &
+     &        nbkt
+
+      integer (kind=int_kind) ::                                        &
+     &        index_bucket
+
+!-----------------------------------------------------------------------
+
+      index_bucket = int(max(zero, (coord - coord0)/dcoord)) + 1
+      index_bucket = min(index_bucket, nbkt)
+
+!-----------------------------------------------------------------------
+
+      end function index_bucket
+
+!***********************************************************************
+
+      subroutine index_search(cindex, bound_box, box,                   &
+     &                        srch_add, num_srch_cells)
+
+!-----------------------------------------------------------------------
+!
+!     this routine returns, in address order, the cells of a grid
+!     whose bounding box overlaps the lat/lon box.  this is the same
+!     list that a full search of the grid's bounding boxes would
+!     give.  srch_add is (re)allocated here.
+!
+!-----------------------------------------------------------------------
+
+      type (cell_index), intent(in) ::                                  &
+     &        cindex            ! cell index of the grid searched
+
+      real (kind=dbl_kind), dimension(:,:), intent(in) ::               &
+     &        bound_box         ! bounding box of each cell of the grid
+
+      real (kind=dbl_kind), dimension(4), intent(in) ::                 &
+     &        box               ! min lat, max lat, min lon, max lon
+
+      integer (kind=int_kind), dimension(:), allocatable,               &
+     &        intent(inout) ::                                          &
+     &        srch_add          ! addresses of the cells found
+
+      integer (kind=int_kind), intent(out) ::                           &
+     &        num_srch_cells    ! number of cells found
+
+!-----------------------------------------------------------------------
+!
+!     local variables
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind) ::                                        &
+     &        ilat1, ilat2, ilon1, ilon2, jlat, jlon,                   &
+     &        i, j, n, nb, cell, max_cells, idum
+
+!-----------------------------------------------------------------------
+!
+!     collect the cells of every bucket the box overlaps.  a cell in
+!     several of these buckets is taken only from the first bucket
+!     (in lat and lon) shared by the cell and the box.
+!
+!-----------------------------------------------------------------------
+
+      call index_range(cindex, box, ilat1, ilat2, ilon1, ilon2)
+
+      max_cells = 0
+      do j=ilat1,ilat2
+        nb = (j-1)*cindex%nlon
+        max_cells = max_cells + cindex%bkt_start(nb+ilon2+1)            &
+     &                        - cindex%bkt_start(nb+ilon1)
+      end do
+
+      if (allocated(srch_add)) deallocate(srch_add)
+      allocate(srch_add(max_cells))
+
+      num_srch_cells = 0
+      do j=ilat1,ilat2
+      do i=ilon1,ilon2
+        nb = (j-1)*cindex%nlon + i
+        do n=cindex%bkt_start(nb),cindex%bkt_start(nb+1)-1
+          cell = cindex%bkt_cells(n)
+
+          if (bound_box(1,cell) <= box(2) .and.                         &
+     &        bound_box(2,cell) >= box(1) .and.                         &
+     &        bound_box(3,cell) <= box(4) .and.                         &
+     &        bound_box(4,cell) >= box(3)) then
+
+            call index_range(cindex, bound_box(:,cell),                 &
+     &                       jlat, idum, jlon, idum)
+            if (max(jlat,ilat1) == j .and. max(jlon,ilon1) == i) then
+              num_srch_cells = num_srch_cells + 1
+              srch_add(num_srch_cells) = cell
+            endif
+
+          endif
+        end do
+      end do
+      end do
+
+      call index_sort(srch_add, num_srch_cells)
+
+!-----------------------------------------------------------------------
+
+      end subroutine index_search
+
+!***********************************************************************
+
+      subroutine index_sort(list, num)
+
+!-----------------------------------------------------------------------
+!
+!     this routine sorts the first num entries of list in increasing
+!     order (heapsort).
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind), dimension(:), intent(inout) ::           &
+     &        list
+
+      integer (kind=int_kind), intent(in) ::                            &
+     &        num
+
+!-----------------------------------------------------------------------
+!
+!     local variables
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind) :: n, parent, child, last, tmp
+
+!-----------------------------------------------------------------------
+
+      if (num < 2) return
+
+      !***
+      !*** build a heap with the largest entry on top
+      !***
+
+      do n=num/2,1,-1
+        parent = n
+        tmp = list(parent)
+        do
+          child = 2*parent
+          if (child > num) exit
+          if (child < num) then
+            if (list(child+1) > list(child)) child = child+1
+          endif
+          if (tmp >= list(child)) exit
+          list(parent) = list(child)
+          parent = child
+        end do
+        list(parent) = tmp
+      end do
+
+      !***
+      !*** move the top of the heap to the end of the list and
+      !*** restore the heap
+      !***
+
+      do last=num,2,-1
+        tmp = list(last)
+        list(last) = list(1)
+        parent = 1
+        do
+          child = 2*parent
+          if (child > last-1) exit
+          if (child < last-1) then
+            if (list(child+1) > list(child)) child = child+1
+          endif
+          if (tmp >= list(child)) exit
+          list(parent) = list(child)
+          parent = child
+        end do
+        list(parent) = tmp
+      end do
+
+!-----------------------------------------------------------------------
+
+      end subroutine index_sort
+
       end module grids
@@ -84,6 +84,37 @@
                              ! lat of each corner of srch cells
      &     srch_corner_lon   ! lon of each corner of srch cells
 
+!$OMP THREADPRIVATE(num_srch_cells, srch_add, srch_corner_lat,          &
+!$OMP&              srch_corner_lon)
+
+!-----------------------------------------------------------------------
+!
+!     links found during a sweep.  the cells of a grid are integrated
+!     concurrently, each thread keeping its links in its own buffer,
+!     and the links are stored afterwards in cell order so that the
+!     weights do not depend on the number of threads.
+!
+!-----------------------------------------------------------------------
+
+      type link_buffer
+        integer (kind=int_kind) ::                                      &
+     &        num_links         ! number of links in buffer
+        integer (kind=int_kind), dimension(:), allocatable ::           &
+     &        add1, add2        ! addresses on grid1, grid2
+        real (kind=dbl_kind), dimension(:,:), allocatable ::            &
+     &        wts               ! weights for each link
+      end type link_buffer
+
+      type (link_buffer), dimension(:), allocatable, save ::            &
+     &        sweep_links       ! link buffer of each thread
+
+      integer (kind=int_kind), dimension(:), allocatable, save ::       &
+     &        cell_thread,                                              &
+                                ! thread that integrated each cell
+     &        cell_link1,                                               &
+                                ! first link of each cell in buffer
+     &        cell_nlinks       ! number of links of each cell
+
 
       integer (kind=int_kind), dimension(:,:), allocatable, save ::     &
      &        link_add1,                                                &
@@ -97,6 +128,8 @@
 
       subroutine remap_conserv
 
+!$    use omp_lib
+
 !-----------------------------------------------------------------------
 !
 !     this routine traces the perimeters of every grid cell on each
@@ -120,10 +153,8 @@
                           ! current linear address for grid1 cell
      &        grid2_add,                                                &
                           ! current linear address for grid2 cell
-     &        min_add,                                                  &
-                          ! addresses for restricting search of
-     &        max_add,                                                  &
-                          !   destination grid
+     &        ithread,                                                  &
+                          ! thread integrating current cell
      &        n, nwgt,                                                  &
                           ! generic counters
      &        corner,                                                   &
@@ -143,9 +174,6 @@
 !     used by scrip_coawst for allocating properly in subroutine
 !     store_conserv
  
-      logical (kind=log_kind), dimension(:), allocatable ::             &
-     &        srch_mask   ! mask for restricting searches
-
       real (kind=dbl_kind) ::                                           &
      &     intrsct_lat, intrsct_lon,                                    &
                                            ! lat/lon of next intersect
@@ -186,66 +214,49 @@
 !
 !-----------------------------------------------------------------------
 
-      allocate(srch_mask(grid2_size))
-
       print *,'grid1 sweep'
       first_call=.true.  ! first_call set to true 
 
-      do grid1_add = 1,grid1_size
+      call timer_start(14)
+      call sweep_init(grid1_size)
 
-        !***
-        !*** restrict searches first using search bins
-        !***
+!$OMP PARALLEL DEFAULT(SHARED)                                          &
+!$OMP& PRIVATE(grid1_add, grid2_add, ithread, n, corner, next_corn,     &
+!$OMP&         num_subseg, lcoinc, lrevers, lbegin, intrsct_lat,        &
+!$OMP&         intrsct_lon, beglat, endlat, beglon, endlon, begseg,     &
+!$OMP&         weights)
 
-        call timer_start(1)
-        min_add = grid2_size
-        max_add = 1
-        do n=1,num_srch_bins
-          if (grid1_add >= bin_addr1(1,n) .and.                         &
-     &        grid1_add <= bin_addr1(2,n)) then
-            min_add = min(min_add, bin_addr2(1,n))
-            max_add = max(max_add, bin_addr2(2,n))
-          endif
-        end do
+      ithread = 0
+!$    ithread = omp_get_thread_num()
+
+!$OMP DO SCHEDULE(DYNAMIC,16)
+      do grid1_add = 1,grid1_size
 
         !***
-        !*** further restrict searches using bounding boxes
+        !*** restrict searches using the cell index of grid2
         !***
 
-        num_srch_cells = 0
-        do grid2_add = min_add,max_add
-        
-          srch_mask(grid2_add) = (grid2_bound_box(1,grid2_add) <=       &
-     &                            grid1_bound_box(2,grid1_add)) .and.   &
-     &                           (grid2_bound_box(2,grid2_add) >=       &
-     &                            grid1_bound_box(1,grid1_add)) .and.   &
-     &                           (grid2_bound_box(3,grid2_add) <=       &
-     &                            grid1_bound_box(4,grid1_add)) .and.   &
-     &                           (grid2_bound_box(4,grid2_add) >=       &
-     &                            grid1_bound_box(3,grid1_add))
-
-          if (srch_mask(grid2_add)) num_srch_cells = num_srch_cells+1
-        end do
+        call timer_start(1)
+        call index_search(grid2_index, grid2_bound_box,                 &
+     &                    grid1_bound_box(:,grid1_add),                 &
+     &                    srch_add, num_srch_cells)
 
         !***
         !*** create search arrays
         !***
 
-        allocate(srch_add(num_srch_cells),                              &
-     &           srch_corner_lat(grid2_corners,num_srch_cells),         &
+        allocate(srch_corner_lat(grid2_corners,num_srch_cells),         &
      &           srch_corner_lon(grid2_corners,num_srch_cells))
 
-        n = 0
-        gather1: do grid2_add = min_add,max_add
-          if (srch_mask(grid2_add)) then
-            n = n+1
-            srch_add(n) = grid2_add
-            srch_corner_lat(:,n) = grid2_corner_lat(:,grid2_add)
-            srch_corner_lon(:,n) = grid2_corner_lon(:,grid2_add)
-          endif
+        gather1: do n=1,num_srch_cells
+          srch_corner_lat(:,n) = grid2_corner_lat(:,srch_add(n))
+          srch_corner_lon(:,n) = grid2_corner_lon(:,srch_add(n))
         end do gather1
         call timer_stop(1)
 
+        cell_thread(grid1_add) = ithread
+        cell_link1(grid1_add) = sweep_links(ithread)%num_links + 1
+
         !***
         !*** integrate around this cell
         !***
@@ -367,13 +378,8 @@
             if (grid2_add /= 0) then
               if (grid1_mask(grid1_add)) then
                 call timer_start(4)
-                call store_link_cnsrv(grid1_add, grid2_add, weights,    &
-     &                                first_call)
+                call sweep_store(ithread, grid1_add, grid2_add, weights)
                 call timer_stop(4)
-                grid1_frac(grid1_add) = grid1_frac(grid1_add) +         &
-     &                                  weights(1)
-                grid2_frac(grid2_add) = grid2_frac(grid2_add) +         &
-     &                                  weights(num_wts+1)
               endif
 
             endif
@@ -400,14 +406,28 @@
 
         end do
 
+        cell_nlinks(grid1_add) = sweep_links(ithread)%num_links -       &
+     &                           cell_link1(grid1_add) + 1
+
         !***
         !*** finished with this cell: deallocate search array and
         !*** start on next cell
 
         deallocate(srch_add, srch_corner_lat, srch_corner_lon)
       end do
+!$OMP END DO
+
+!$OMP END PARALLEL
+
+      call timer_stop(14)
 
-      deallocate(srch_mask)
+      !***
+      !*** store links in grid1 cell order
+      !***
+
+      call timer_start(16)
+      call sweep_finish(grid1_size, first_call)
+      call timer_stop(16)
 
 !-----------------------------------------------------------------------
 !
@@ -415,60 +435,44 @@
 !
 !-----------------------------------------------------------------------
 
-      allocate(srch_mask(grid1_size))
-
       print *,'grid2 sweep '
-   
+
+      call timer_start(15)
+      call sweep_init(grid2_size)
+
+!$OMP PARALLEL DEFAULT(SHARED)                                          &
+!$OMP& PRIVATE(grid1_add, grid2_add, ithread, n, corner, next_corn,     &
+!$OMP&         num_subseg, lcoinc, lrevers, lbegin, intrsct_lat,        &
+!$OMP&         intrsct_lon, beglat, endlat, beglon, endlon, begseg,     &
+!$OMP&         weights)
+
+      ithread = 0
+!$    ithread = omp_get_thread_num()
+
+!$OMP DO SCHEDULE(DYNAMIC,16)
       do grid2_add = 1,grid2_size
         
         !***
-        !*** restrict searches first using search bins
+        !*** restrict searches using the cell index of grid1
         !***
 
         call timer_start(5)
-        min_add = grid1_size
-        max_add = 1
-        do n=1,num_srch_bins
-          if (grid2_add >= bin_addr2(1,n) .and.                         &
-     &        grid2_add <= bin_addr2(2,n)) then
-            min_add = min(min_add, bin_addr1(1,n))
-            max_add = max(max_add, bin_addr1(2,n))
-          endif
-        end do
-
-        !***
-        !*** further restrict searches using bounding boxes
-        !***
+        call index_search(grid1_index, grid1_bound_box,                 &
+     &                    grid2_bound_box(:,grid2_add),                 &
+     &                    srch_add, num_srch_cells)
 
-        num_srch_cells = 0
-        do grid1_add = min_add, max_add
-          srch_mask(grid1_add) = (grid1_bound_box(1,grid1_add) <=       &
-     &                            grid2_bound_box(2,grid2_add)) .and.   &
-     &                           (grid1_bound_box(2,grid1_add) >=       &
-     &                            grid2_bound_box(1,grid2_add)) .and.   &
-     &                           (grid1_bound_box(3,grid1_add) <=       &
-     &                            grid2_bound_box(4,grid2_add)) .and.   &
-     &                           (grid1_bound_box(4,grid1_add) >=       &
-     &                            grid2_bound_box(3,grid2_add))
-
-          if (srch_mask(grid1_add)) num_srch_cells = num_srch_cells+1
-        end do
-
-        allocate(srch_add(num_srch_cells),                              &
-     &           srch_corner_lat(grid1_corners,num_srch_cells),         &
+        allocate(srch_corner_lat(grid1_corners,num_srch_cells),         &
      &           srch_corner_lon(grid1_corners,num_srch_cells))
 
-        n = 0
-        gather2: do grid1_add = min_add,max_add
-          if (srch_mask(grid1_add)) then
-            n = n+1
-            srch_add(n) = grid1_add
-            srch_corner_lat(:,n) = grid1_corner_lat(:,grid1_add)
-            srch_corner_lon(:,n) = grid1_corner_lon(:,grid1_add)
-          endif
+        gather2: do n=1,num_srch_cells
+          srch_corner_lat(:,n) = grid1_corner_lat(:,srch_add(n))
+          srch_corner_lon(:,n) = grid1_corner_lon(:,srch_add(n))
         end do gather2
         call timer_stop(5)
 
+        cell_thread(grid2_add) = ithread
+        cell_link1(grid2_add) = sweep_links(ithread)%num_links + 1
+
         !***
         !*** integrate around this cell
         !***
@@ -583,13 +587,8 @@
             if (.not. lcoinc .and. grid1_add /= 0) then
               if (grid1_mask(grid1_add)) then
                 call timer_start(8)
-                call store_link_cnsrv(grid1_add, grid2_add, weights,    &
-     &                                first_call)
+                call sweep_store(ithread, grid1_add, grid2_add, weights)
                 call timer_stop(8)
-                grid1_frac(grid1_add) = grid1_frac(grid1_add) +         &
-     &                                  weights(1)
-                grid2_frac(grid2_add) = grid2_frac(grid2_add) +         &
-     &                                  weights(num_wts+1)
               endif
 
             endif
@@ -617,6 +616,9 @@
 
         end do
 
+        cell_nlinks(grid2_add) = sweep_links(ithread)%num_links -       &
+     &                           cell_link1(grid2_add) + 1
+
         !***
         !*** finished with this cell: deallocate search array and
         !*** start on next cell
@@ -624,8 +626,19 @@
         deallocate(srch_add, srch_corner_lat, srch_corner_lon)
 
       end do
+!$OMP END DO
 
-      deallocate(srch_mask)
+!$OMP END PARALLEL
+
+      call timer_stop(15)
+
+      !***
+      !*** store links in grid2 cell order
+      !***
+
+      call timer_start(16)
+      call sweep_finish(grid2_size, first_call)
+      call timer_stop(16)
 
 !-----------------------------------------------------------------------
 !
@@ -1058,6 +1071,8 @@
      &     intrsct_lat_off, intrsct_lon_off ! lat/lon coords offset 
                                             ! for next search
 
+!$OMP THREADPRIVATE(last_loc, lthresh, intrsct_lat_off, intrsct_lon_off)
+
 !-----------------------------------------------------------------------
 !
 !     initialize defaults, flags, etc.
@@ -1557,6 +1572,9 @@
       real (kind=dbl_kind), save ::                                     &
      &     avoid_pole_offset = tiny  ! endpoint offset to avoid pole
 
+!$OMP THREADPRIVATE(luse_last, intrsct_x, intrsct_y, avoid_pole_count,  &
+!$OMP&              avoid_pole_offset)
+
 !-----------------------------------------------------------------------
 !
 !     initialize defaults, flags, etc.
@@ -2143,6 +2161,150 @@
 
       end subroutine line_integral
 
+!***********************************************************************
+
+      subroutine sweep_init(num_cells)
+
+!-----------------------------------------------------------------------
+!
+!     this routine allocates a link buffer for each thread and the
+!     arrays locating the links of each cell in these buffers.
+!
+!-----------------------------------------------------------------------
+
+!$    use omp_lib
+
+      integer (kind=int_kind), intent(in) ::                            &
+     &        num_cells   ! number of cells on the grid swept
+
+      integer (kind=int_kind), parameter ::                             &
+     &        init_links = 4096 ! initial size of each buffer
+
+      integer (kind=int_kind) :: nthreads, n
+
+!-----------------------------------------------------------------------
+
+      nthreads = 1
+!$    nthreads = omp_get_max_threads()
+
+      allocate(sweep_links(0:nthreads-1))
+      do n=0,nthreads-1
+        sweep_links(n)%num_links = 0
+        allocate(sweep_links(n)%add1(init_links),                       &
+     &           sweep_links(n)%add2(init_links),                       &
+     &           sweep_links(n)%wts(2*num_wts,init_links))
+      end do
+
+      allocate(cell_thread(num_cells), cell_link1(num_cells),           &
+     &         cell_nlinks(num_cells))
+      cell_thread = 0
+      cell_link1  = 1
+      cell_nlinks = 0
+
+!-----------------------------------------------------------------------
+
+      end subroutine sweep_init
+
+!***********************************************************************
+
+      subroutine sweep_store(ithread, add1, add2, weights)
+
+!-----------------------------------------------------------------------
+!
+!     this routine adds a link to the buffer of a thread, resizing the
+!     buffer if necessary.
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind), intent(in) ::                            &
+     &        ithread,                                                  &
+                     ! thread owning the buffer
+     &        add1,                                                     &
+                     ! address on grid1
+     &        add2   ! address on grid2
+
+      real (kind=dbl_kind), dimension(:), intent(in) ::                 &
+     &        weights ! array of remapping weights for this link
+
+      integer (kind=int_kind) :: nlink, max_links
+
+      integer (kind=int_kind), dimension(:), allocatable :: itmp
+
+      real (kind=dbl_kind), dimension(:,:), allocatable :: rtmp
+
+!-----------------------------------------------------------------------
+!
+!     if all weights are zero, the link adds nothing
+!
+!-----------------------------------------------------------------------
+
+      if (all(weights == zero)) return
+
+      nlink = sweep_links(ithread)%num_links + 1
+      max_links = size(sweep_links(ithread)%add1)
+
+      if (nlink > max_links) then
+        allocate(itmp(2*max_links))
+        itmp(1:max_links) = sweep_links(ithread)%add1
+        call move_alloc(itmp, sweep_links(ithread)%add1)
+        allocate(itmp(2*max_links))
+        itmp(1:max_links) = sweep_links(ithread)%add2
+        call move_alloc(itmp, sweep_links(ithread)%add2)
+        allocate(rtmp(2*num_wts,2*max_links))
+        rtmp(:,1:max_links) = sweep_links(ithread)%wts
+        call move_alloc(rtmp, sweep_links(ithread)%wts)
+      endif
+
+      sweep_links(ithread)%add1(nlink) = add1
+      sweep_links(ithread)%add2(nlink) = add2
+      sweep_links(ithread)%wts(:,nlink) = weights(1:2*num_wts)
+      sweep_links(ithread)%num_links = nlink
+
+!-----------------------------------------------------------------------
+
+      end subroutine sweep_store
+
+!***********************************************************************
+
+      subroutine sweep_finish(num_cells, first_call)
+
+!-----------------------------------------------------------------------
+!
+!     this routine stores the links found during a sweep in the order
+!     of the cells swept, which is the order of a serial sweep, and
+!     adds them to the fractional areas.  the buffers are then freed.
+!
+!-----------------------------------------------------------------------
+
+      integer (kind=int_kind), intent(in) ::                            &
+     &        num_cells   ! number of cells on the grid swept
+
+      logical (kind=log_kind), intent(inout) :: first_call
+
+      integer (kind=int_kind) :: cell, nlink, n, add1, add2
+
+!-----------------------------------------------------------------------
+
+      do cell=1,num_cells
+        n = cell_thread(cell)
+        do nlink=cell_link1(cell),cell_link1(cell)+cell_nlinks(cell)-1
+          add1 = sweep_links(n)%add1(nlink)
+          add2 = sweep_links(n)%add2(nlink)
+          call store_link_cnsrv(add1, add2,                             &
+     &                          sweep_links(n)%wts(:,nlink), first_call)
+          grid1_frac(add1) = grid1_frac(add1) +                         &
+     &                       sweep_links(n)%wts(1,nlink)
+          grid2_frac(add2) = grid2_frac(add2) +                         &
+     &                       sweep_links(n)%wts(num_wts+1,nlink)
+        end do
+      end do
+
+      deallocate(sweep_links, cell_thread, cell_link1, cell_nlinks)
+
+!-----------------------------------------------------------------------
+
+      end subroutine sweep_finish
+
 !***********************************************************************
 
       subroutine store_link_cnsrv(add1, add2, weights, first_call)
@@ -256,6 +256,10 @@
 !     DEALLOCATE HERE for SCRIP_COAWST package
       write(stdout,*) "-------------------------------------------"
       write(stdout,*) "Reached the end of mapping one set of grids"
+      write(stdout,*) "Time for grid1 sweep, grid2 sweep, storing links"
+      call timer_print(14)
+      call timer_print(15)
+      call timer_print(16)
 !     deallocate arrays from grids.f
       deallocate ( grid1_dims, grid2_dims )
       deallocate ( grid1_area, grid2_area )
@@ -267,6 +271,8 @@
       deallocate ( grid1_corner_lat, grid2_corner_lat)
       deallocate ( grid1_bound_box, grid2_bound_box)
       deallocate( bin_addr1, bin_addr2, bin_lats, bin_lons)
+      deallocate( grid1_index%bkt_start, grid1_index%bkt_cells)
+      deallocate( grid2_index%bkt_start, grid2_index%bkt_cells)
       deallocate( grid1_add_map1, grid2_add_map1)
       deallocate( wts_map1)
 !     deallocate arrays from remap_conserv.f
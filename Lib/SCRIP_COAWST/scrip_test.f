@@ -45,6 +45,7 @@
       use remap_vars   ! module containing remapping info
       use remap_mod    ! module containing remapping routines
       use remap_read   ! routines for reading remap files
+      use timers       ! CPU timers
 
       implicit none
 
@@ -132,13 +133,26 @@
       call release_unit(iunit)
       write(*,nml=remap_inputs)
 
+!-----------------------------------------------------------------------
+!
+!     initialize timers: 1 = read remap file, 2 = apply first-order map
+!
+!-----------------------------------------------------------------------
+
+      call timers_init
+      do n=1,max_timers
+        call timer_clear(n)
+      end do
+
 !-----------------------------------------------------------------------
 !
 !     read remapping data
 !
 !-----------------------------------------------------------------------
 
+      call timer_start(1)
       call read_remap(map_name, interp_file)
+      call timer_stop(1)
 
 !-----------------------------------------------------------------------
 !
@@ -709,6 +723,7 @@
       grad1_lat_zero = zero
       grad1_lon_zero = zero
 
+      call timer_start(2)
       if (map_type /= map_type_bicubic) then
         call remap(grid2_tmp, wts_map1, grid2_add_map1, grid1_add_map1, &
      &             grid1_array)
@@ -718,6 +733,7 @@
      &                          src_grad2=grad1_lon,                    &
      &                          src_grad3=grad1_latlon)
       endif
+      call timer_stop(2)
 
       if (map_type == map_type_conserv) then
         select case (norm_opt)
@@ -978,6 +994,17 @@
         imax = imax + idiff
       end do
 
+!-----------------------------------------------------------------------
+!
+!     print timings
+!
+!-----------------------------------------------------------------------
+
+      print *,'time to read remap file'
+      call timer_print(1)
+      print *,'time to apply first-order map'
+      call timer_print(2)
+
 !-----------------------------------------------------------------------
 
       end program remap_test
@@ -211,6 +211,8 @@
 
       subroutine timer_start(timer)
 
+!$    use omp_lib
+
 !-----------------------------------------------------------------------
 !
 !     This routine starts a given timer.
@@ -228,6 +230,13 @@
 
 !-----------------------------------------------------------------------
 
+      !---
+      !--- timers are shared by all threads, so timers inside a
+      !--- parallel region are not used
+      !---
+
+!$    if (omp_in_parallel()) return
+
       !---
       !--- Start the timer and change timer status.
       !---
@@ -245,6 +254,8 @@
 
       subroutine timer_stop(timer)
 
+!$    use omp_lib
+
 !-----------------------------------------------------------------------
 !
 !     This routine stops a given timer.
@@ -262,6 +273,8 @@
 
 !-----------------------------------------------------------------------
 
+!$    if (omp_in_parallel()) return
+
       if (status(timer) .eq. 'running') then
 
         !---
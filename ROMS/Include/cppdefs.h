@@ -470,6 +470,7 @@
 ** CLIPPING_SPLIT      use to separate analysis due to IC, forcing, and OBC  **
 ** DATALESS_LOOPS      use if testing convergence of Picard iterations       **
 ** ENKF_RESTART        use if writting restart fields for EnKF               **
+** FORWARD_CACHE       use if caching forward solution in inner loops        **
 ** FORWARD_MIXING      use if processing forward vertical mixing coefficient **
 ** FORWARD_WRITE       use if writing out forward solution, basic state      **
 ** FORWARD_READ        use if reading in  forward solution, basic state      **
@@ -491,6 +491,9 @@
      defined W4DVAR)
 # define FORWARD_WRITE
 #endif
+#if defined FORWARD_CACHE && !defined FORWARD_READ
+# undef FORWARD_CACHE
+#endif
 
 /*
 ** Set internal weak constraint switches.
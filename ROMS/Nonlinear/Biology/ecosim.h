@@ -111,6 +111,8 @@
       USE mod_eclight
       USE mod_scalars
       USE mod_iounits
+!
+      USE bio_sink_mod, ONLY : bio_sink_depart, bio_sink_ppm
 !
 !  Imported variable declarations.
 !
@@ -145,12 +147,13 @@
 !
       integer, parameter :: Msink = 30
 
-      integer :: Iter, Tindex, i, isink, ibio, id, itrc, j, k, ic, ks
+      integer :: Iter, Tindex, i, isink, ibio, id, itrc, j, k, ic
       integer :: ibac, iband, idom, ifec, iphy, ipig
       integer :: Nsink
 
       integer, dimension(Msink) :: idsink
-      integer, dimension(IminS:ImaxS,N(ng)) :: ksource
+      integer, dimension(Msink) :: igeo
+      integer, allocatable :: ksource(:,:,:)
 
       real(r8), parameter :: MinVal = 0.0_r8
 
@@ -162,7 +165,7 @@
 
       real(r8) :: Het_BAC
       real(r8) :: N_quota, RelDOC1, RelDON1, RelDOP1, RelFe
-      real(r8) :: cff, cff1, cffL, cffR, cu, dltL, dltR
+      real(r8) :: cff, cff1
 
       real(r8), dimension(Msink) :: Wbio
 
@@ -242,15 +245,11 @@
       real(r8), dimension(IminS:ImaxS,N(ng),NT(ng)) :: Bio_old
       real(r8), dimension(IminS:ImaxS,N(ng),NT(ng)) :: Bio_new
 
-      real(r8), dimension(IminS:ImaxS,0:N(ng)) :: FC
+      real(r8), dimension(IminS:ImaxS,Msink) :: FC
       real(r8), dimension(IminS:ImaxS,N(ng)) :: Hz_inv
       real(r8), dimension(IminS:ImaxS,N(ng)) :: Hz_inv2
       real(r8), dimension(IminS:ImaxS,N(ng)) :: Hz_inv3
-      real(r8), dimension(IminS:ImaxS,N(ng)) :: WL
-      real(r8), dimension(IminS:ImaxS,N(ng)) :: WR
-      real(r8), dimension(IminS:ImaxS,N(ng)) :: bL
-      real(r8), dimension(IminS:ImaxS,N(ng)) :: bR
-      real(r8), dimension(IminS:ImaxS,N(ng)) :: qc
+      real(r8), allocatable :: cu(:,:,:)
 
 #include "set_bounds.h"
 !
@@ -305,6 +304,13 @@
       END DO
       Nsink=ic-1
 !
+!  Departure point work arrays of the sinking scheme, sized to the
+!  sinking variables in use. They are allocated rather than automatic
+!  to keep them off the (thread) stack.
+!
+      allocate ( ksource(IminS:ImaxS,N(ng),Nsink) )
+      allocate ( cu(IminS:ImaxS,N(ng),Nsink) )
+!
 !-----------------------------------------------------------------------
 !  Compute inverse thickness to avoid repeated divisions.
 !-----------------------------------------------------------------------
@@ -326,6 +332,17 @@
           END DO
         END DO
 !
+!  Compute the departure points of the semi-Lagrangian sinking scheme.
+!  They depend only on the grid and on the sinking velocities, so they
+!  are computed once here for all the biological iterations.
+!
+        CALL bio_sink_depart (ng, Istr, Iend,                           &
+     &                        LBi, UBi, LBj, UBj, UBk,                  &
+     &                        IminS, ImaxS, j,                          &
+     &                        Nsink, dtbio, Wbio,                       &
+     &                        Hz, z_w, Hz_inv,                          &
+     &                        igeo, ksource, cu)
+!
 !-----------------------------------------------------------------------
 !  Extract biological variables from tracer arrays, place them into
 !  scratch arrays, and restrict their values to be positive definite.
@@ -2091,178 +2108,15 @@
 !
 !  Reconstruct vertical profile of selected biological constituents
 !  "Bio(:,:,isink)" in terms of a set of parabolic segments within each
-!  grid box. Then, compute semi-Lagrangian flux due to sinking.
-!
-          SINK_LOOP: DO isink=1,Nsink
-            itrc=idsink(isink)
-!
-!  Copy concentration of biological particulates into scratch array
-!  "qc" (q-central, restrict it to be positive) which is hereafter
-!  interpreted as a set of grid-box averaged values for biogeochemical
-!  constituent concentration.
-!
-            DO k=1,N(ng)
-              DO i=Istr,Iend
-                qc(i,k)=Bio(i,k,itrc)
-              END DO
-            END DO
-!
-            DO k=N(ng)-1,1,-1
-              DO i=Istr,Iend
-                FC(i,k)=(qc(i,k+1)-qc(i,k))*Hz_inv2(i,k)
-              END DO
-            END DO
-            DO k=2,N(ng)-1
-              DO i=Istr,Iend
-                dltR=Hz(i,j,k)*FC(i,k)
-                dltL=Hz(i,j,k)*FC(i,k-1)
-                cff=Hz(i,j,k-1)+2.0_r8*Hz(i,j,k)+Hz(i,j,k+1)
-                cffR=cff*FC(i,k)
-                cffL=cff*FC(i,k-1)
-!
-!  Apply PPM monotonicity constraint to prevent oscillations within the
-!  grid box.
-!
-                IF ((dltR*dltL).le.0.0_r8) THEN
-                  dltR=0.0_r8
-                  dltL=0.0_r8
-                ELSE IF (ABS(dltR).gt.ABS(cffL)) THEN
-                  dltR=cffL
-                ELSE IF (ABS(dltL).gt.ABS(cffR)) THEN
-                  dltL=cffR
-                END IF
-!
-!  Compute right and left side values (bR,bL) of parabolic segments
-!  within grid box Hz(k); (WR,WL) are measures of quadratic variations.
-!
-!  NOTE: Although each parabolic segment is monotonic within its grid
-!        box, monotonicity of the whole profile is not guaranteed,
-!        because bL(k+1)-bR(k) may still have different sign than
-!        qc(i,k+1)-qc(i,k).  This possibility is excluded,
-!        after bL and bR are reconciled using WENO procedure.
-!
-                cff=(dltR-dltL)*Hz_inv3(i,k)
-                dltR=dltR-cff*Hz(i,j,k+1)
-                dltL=dltL+cff*Hz(i,j,k-1)
-                bR(i,k)=qc(i,k)+dltR
-                bL(i,k)=qc(i,k)-dltL
-                WR(i,k)=(2.0_r8*dltR-dltL)**2
-                WL(i,k)=(dltR-2.0_r8*dltL)**2
-              END DO
-            END DO
-            cff=1.0E-14_r8
-            DO k=2,N(ng)-2
-              DO i=Istr,Iend
-                dltL=MAX(cff,WL(i,k  ))
-                dltR=MAX(cff,WR(i,k+1))
-                bR(i,k)=(dltR*bR(i,k)+dltL*bL(i,k+1))/(dltR+dltL)
-                bL(i,k+1)=bR(i,k)
-              END DO
-            END DO
-            DO i=Istr,Iend
-              FC(i,N(ng))=0.0_r8            ! NO-flux boundary condition
-#if defined LINEAR_CONTINUATION
-              bL(i,N(ng))=bR(i,N(ng)-1)
-              bR(i,N(ng))=2.0_r8*qc(i,N(ng))-bL(i,N(ng))
-#elif defined NEUMANN
-              bL(i,N(ng))=bR(i,N(ng)-1)
-              bR(i,N(ng))=1.5_r8*qc(i,N(ng))-0.5_r8*bL(i,N(ng))
-#else
-              bR(i,N(ng))=qc(i,N(ng))       ! default strictly monotonic
-              bL(i,N(ng))=qc(i,N(ng))       ! conditions
-              bR(i,N(ng)-1)=qc(i,N(ng))
-#endif
-#if defined LINEAR_CONTINUATION
-              bR(i,1)=bL(i,2)
-              bL(i,1)=2.0_r8*qc(i,1)-bR(i,1)
-#elif defined NEUMANN
-              bR(i,1)=bL(i,2)
-              bL(i,1)=1.5_r8*qc(i,1)-0.5_r8*bR(i,1)
-#else
-              bL(i,2)=qc(i,1)               ! bottom grid boxes are
-              bR(i,1)=qc(i,1)               ! re-assumed to be
-              bL(i,1)=qc(i,1)               ! piecewise constant.
-#endif
-            END DO
-!
-!  Apply monotonicity constraint again, since the reconciled interfacial
-!  values may cause a non-monotonic behavior of the parabolic segments
-!  inside the grid box.
-!
-            DO k=1,N(ng)
-              DO i=Istr,Iend
-                dltR=bR(i,k)-qc(i,k)
-                dltL=qc(i,k)-bL(i,k)
-                cffR=2.0_r8*dltR
-                cffL=2.0_r8*dltL
-                IF ((dltR*dltL).lt.0.0_r8) THEN
-                  dltR=0.0_r8
-                  dltL=0.0_r8
-                ELSE IF (ABS(dltR).gt.ABS(cffL)) THEN
-                  dltR=cffL
-                ELSE IF (ABS(dltL).gt.ABS(cffR)) THEN
-                  dltL=cffR
-                END IF
-                bR(i,k)=qc(i,k)+dltR
-                bL(i,k)=qc(i,k)-dltL
-              END DO
-            END DO
-!
-!  After this moment reconstruction is considered complete. The next
-!  stage is to compute vertical advective fluxes, FC. It is expected
-!  that sinking may occurs relatively fast, the algorithm is designed
-!  to be free of CFL criterion, which is achieved by allowing
-!  integration bounds for semi-Lagrangian advective flux to use as
-!  many grid boxes in upstream direction as necessary.
-!
-!  In the two code segments below, WL is the z-coordinate of the
-!  departure point for grid box interface z_w with the same indices;
-!  FC is the finite volume flux; ksource(:,k) is index of vertical
-!  grid box which contains the departure point (restricted by N(ng)).
-!  During the search: also add in content of whole grid boxes
-!  participating in FC.
-!
-            cff=dtbio*ABS(Wbio(isink))
-            DO k=1,N(ng)
-              DO i=Istr,Iend
-                FC(i,k-1)=0.0_r8
-                WL(i,k)=z_w(i,j,k-1)+cff
-                WR(i,k)=Hz(i,j,k)*qc(i,k)
-                ksource(i,k)=k
-              END DO
-            END DO
-            DO k=1,N(ng)
-              DO ks=k,N(ng)-1
-                DO i=Istr,Iend
-                  IF (WL(i,k).gt.z_w(i,j,ks)) THEN
-                    ksource(i,k)=ks+1
-                    FC(i,k-1)=FC(i,k-1)+WR(i,ks)
-                  END IF
-                END DO
-              END DO
-            END DO
-!
-!  Finalize computation of flux: add fractional part.
-!
-            DO k=1,N(ng)
-              DO i=Istr,Iend
-                ks=ksource(i,k)
-                cu=MIN(1.0_r8,(WL(i,k)-z_w(i,j,ks-1))*Hz_inv(i,ks))
-                FC(i,k-1)=FC(i,k-1)+                                    &
-     &                    Hz(i,j,ks)*cu*                                &
-     &                    (bL(i,ks)+                                    &
-     &                     cu*(0.5_r8*(bR(i,ks)-bL(i,ks))-              &
-     &                         (1.5_r8-cu)*                             &
-     &                         (bR(i,ks)+bL(i,ks)-                      &
-     &                          2.0_r8*qc(i,ks))))
-              END DO
-            END DO
-            DO k=1,N(ng)
-              DO i=Istr,Iend
-                Bio(i,k,itrc)=qc(i,k)+(FC(i,k)-FC(i,k-1))*Hz_inv(i,k)
-              END DO
-            END DO
-
+!  grid box. Then, compute semi-Lagrangian flux due to sinking.  The
+!  flux out of the bottom grid box is returned in FC.
+!
+          CALL bio_sink_ppm (ng, Istr, Iend,                            &
+     &                       LBi, UBi, LBj, UBj, UBk,                   &
+     &                       IminS, ImaxS, j,                           &
+     &                       Nsink, idsink, igeo,                       &
+     &                       Hz, Hz_inv, Hz_inv2, Hz_inv3,              &
+     &                       ksource, cu, Bio, FC)
 #ifdef BIO_SEDIMENT
 !
 !  Particulate flux reaching the seafloor is remineralized and returned
@@ -2272,30 +2126,32 @@
 !  parameterization that includes the time delay of remineralization
 !  and dissolved oxygen.
 !
+          SINK_LOOP: DO isink=1,Nsink
+            itrc=idsink(isink)
             DO ifec=1,Nfec
               IF (itrc.eq.iFecN(ifec)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iNO3_)=Bio(i,1,iNO3_)+cff1
                 END DO
               ELSE IF (itrc.eq.iFecC(ifec)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iDIC_)=Bio(i,1,iDIC_)+cff1
                 END DO
               ELSE IF (itrc.eq.iFecP(ifec)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iPO4_)=Bio(i,1,iPO4_)+cff1
                 END DO
               ELSE IF (itrc.eq.iFecS(ifec)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iSiO_)=Bio(i,1,iSiO_)+cff1
                 END DO
               ELSE IF (itrc.eq.iFecF(ifec)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iFeO_)=Bio(i,1,iFeO_)+cff1
                 END DO
               END IF
@@ -2303,33 +2159,33 @@
             DO iphy=1,Nphy
               IF (itrc.eq.iPhyN(iphy)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iNO3_)=Bio(i,1,iNO3_)+cff1
                 END DO
               ELSE IF (itrc.eq.iPhyC(iphy)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iDIC_)=Bio(i,1,iDIC_)+cff1
                 END DO
               ELSE IF (itrc.eq.iPhyP(iphy)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iPO4_)=Bio(i,1,iPO4_)+cff1
                 END DO
               ELSE IF (itrc.eq.iPhyS(iphy)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iSiO_)=Bio(i,1,iSiO_)+cff1
                 END DO
               ELSE IF (itrc.eq.iPhyF(iphy)) THEN
                 DO i=Istr,Iend
-                  cff1=FC(i,0)*Hz_inv(i,1)
+                  cff1=FC(i,isink)*Hz_inv(i,1)
                   Bio(i,1,iFeO_)=Bio(i,1,iFeO_)+cff1
                 END DO
               END IF
             END DO
-#endif
           END DO SINK_LOOP
+#endif
 !
 !-----------------------------------------------------------------------
 !  Update the tendency arrays
@@ -2371,6 +2227,8 @@
           END DO
         END DO
       END DO J_LOOP
+!
+      deallocate ( ksource, cu )
 
       RETURN
       END SUBROUTINE biology_tile
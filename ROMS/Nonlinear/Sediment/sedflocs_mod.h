@@ -53,7 +53,11 @@
         real(r8), pointer :: f_l4(:,:)
         real(r8), pointer :: f_g1_sh(:,:,:)
         real(r8), pointer :: f_g1_ds(:,:,:)
-        real(r8), pointer :: f_g4(:,:,:)
+        real(r8), pointer :: f_g4_one(:,:,:)
+        real(r8), pointer :: f_g4_both(:,:,:)
+        real(r8), pointer :: f_gcf_min(:,:)
+        real(r8), pointer :: f_gcf_max(:,:)
+        real(r8), pointer :: f_gcf_l4(:,:)
 #endif
 
       END TYPE T_SEDFLOCS
@@ -101,7 +105,11 @@
       allocate ( SEDFLOCS(ng) % f_l4(NCS,NCS) )
       allocate ( SEDFLOCS(ng) % f_g1_sh(NCS,NCS,NCS) )
       allocate ( SEDFLOCS(ng) % f_g1_ds(NCS,NCS,NCS) )
-      allocate ( SEDFLOCS(ng) % f_g4(NCS,NCS,NCS) )
+      allocate ( SEDFLOCS(ng) % f_g4_one(NCS,NCS,NCS) )
+      allocate ( SEDFLOCS(ng) % f_g4_both(NCS,NCS,NCS) )
+      allocate ( SEDFLOCS(ng) % f_gcf_min(NCS,NCS) )
+      allocate ( SEDFLOCS(ng) % f_gcf_max(NCS,NCS) )
+      allocate ( SEDFLOCS(ng) % f_gcf_l4(NCS,NCS) )
 #endif
 
 
@@ -176,6 +184,7 @@
         CALL initialize_sedflocs_param (ng, tile,                       &
      &                     SEDFLOCS(ng) % f_mass,                       &
      &                     SEDFLOCS(ng) % f_diam,                       &
+     &                     SEDFLOCS(ng) % f_rho,                        &
      &                     SEDFLOCS(ng) % f_g1_sh,                      &
      &                     SEDFLOCS(ng) % f_g1_ds,                      &
      &                     SEDFLOCS(ng) % f_g3,                         &
@@ -184,6 +193,17 @@
      &                     SEDFLOCS(ng) % f_coll_prob_sh,               &
      &                     SEDFLOCS(ng) % f_coll_prob_ds,               &
      &                     SEDFLOCS(ng) % f_l3)
+        CALL initialize_sedflocs_collfrag (ng,                          &
+     &                     SEDFLOCS(ng) % f_mass,                       &
+     &                     SEDFLOCS(ng) % f_diam,                       &
+     &                     SEDFLOCS(ng) % f_rho,                        &
+     &                     SEDFLOCS(ng) % f_coll_prob_sh,               &
+     &                     SEDFLOCS(ng) % f_g4_one,                     &
+     &                     SEDFLOCS(ng) % f_g4_both,                    &
+     &                     SEDFLOCS(ng) % f_l4,                         &
+     &                     SEDFLOCS(ng) % f_gcf_min,                    &
+     &                     SEDFLOCS(ng) % f_gcf_max,                    &
+     &                     SEDFLOCS(ng) % f_gcf_l4)
 !
       END IF
 !
@@ -192,7 +212,7 @@
 !
 !***********************************************************************
       SUBROUTINE initialize_sedflocs_param (ng, tile,                   &
-     &                              f_mass,f_diam,f_g1_sh,              &
+     &                              f_mass,f_diam,f_rho,f_g1_sh,        &
      &                              f_g1_ds,f_g3,f_l1_sh,f_l1_ds,       &
      &                              f_coll_prob_sh,f_coll_prob_ds,      &
      &                              f_l3)
@@ -209,6 +229,7 @@
       integer, intent(in) :: ng, tile
       real(r8), intent(inout) :: f_mass(0:NCS+1)
       real(r8), intent(inout) :: f_diam(NCS)
+      real(r8), intent(inout) :: f_rho(NCS)
       real(r8), intent(inout) :: f_g1_sh(NCS,NCS,NCS)
       real(r8), intent(inout) :: f_g1_ds(NCS,NCS,NCS)
       real(r8), intent(inout) :: f_g3(NCS,NCS)
@@ -223,7 +244,7 @@
       logical  :: f_test
       real(r8) :: f_weight,mult,dfragmax
       integer  :: iv1,iv2,iv3,iv,itrc
-      real(r8) :: f_vol(NCS),f_rho(NCS)
+      real(r8) :: f_vol(NCS)
       real(r8), parameter :: mu = 0.001_r8
       real(r8) :: eps
       eps = epsilon(1.0)
@@ -255,6 +276,7 @@
      &     (f_dp0/f_diam(itrc))**(3.0_r8-f_nf)
          f_mass(itrc)=f_vol(itrc)*(f_rho(itrc)-rhoref)
       ENDDO
+      f_mass(0)=0.0_r8
       f_mass(NCS+1)=f_mass(NCS)*2.0_r8+1.0_r8
       IF (f_diam(1).eq.f_dp0)  THEN
           f_mass(1)=f_vol(1)*Srho(1,ng)
@@ -523,3 +545,155 @@
 
       RETURN
       END SUBROUTINE initialize_sedflocs_param
+!
+!***********************************************************************
+      SUBROUTINE initialize_sedflocs_collfrag (ng, f_mass, f_diam,      &
+     &                                         f_rho, f_coll_prob_sh,   &
+     &                                         f_g4_one, f_g4_both,     &
+     &                                         f_l4, f_gcf_min,         &
+     &                                         f_gcf_max, f_gcf_l4)
+!***********************************************************************
+!
+!  Collision fragmentation kernels (former flocmod_collfrag).  A pair
+!  of flocs (iv2,iv3) fragments when the collision shear number
+!
+!      gcolfrag = Gval**2 * f_gcf(iv2,iv3)
+!
+!  exceeds one, where the coefficient f_gcf depends only on the class
+!  geometry.  The kernels are therefore computed once here for the two
+!  possible outcomes, and sed_flocmod picks them for the local shear:
+!
+!    f_g4_one    only the larger floc of the pair breaks up
+!                (Gval**2*f_gcf_min < 1 <= Gval**2*f_gcf_max)
+!    f_g4_both   both flocs break up (1 <= Gval**2*f_gcf_min)
+!    f_l4        loss of class iv1 by collision with class iv2, which
+!                applies when 1 <= Gval**2*f_gcf_l4(iv2,iv1)
+!
+!  All kernels include the f_collfragparam factor.
+!
+      USE mod_param
+      USE mod_scalars
+      USE mod_sediment
+!
+      implicit none
+!
+!  Imported variable declarations.
+!
+      integer, intent(in) :: ng
+      real(r8), intent(in) :: f_mass(0:NCS+1)
+      real(r8), intent(in) :: f_diam(NCS)
+      real(r8), intent(in) :: f_rho(NCS)
+      real(r8), intent(in) :: f_coll_prob_sh(NCS,NCS)
+      real(r8), intent(out) :: f_g4_one(NCS,NCS,NCS)
+      real(r8), intent(out) :: f_g4_both(NCS,NCS,NCS)
+      real(r8), intent(out) :: f_l4(NCS,NCS)
+      real(r8), intent(out) :: f_gcf_min(NCS,NCS)
+      real(r8), intent(out) :: f_gcf_max(NCS,NCS)
+      real(r8), intent(out) :: f_gcf_l4(NCS,NCS)
+!
+!  Local variable declarations.
+!
+      integer  :: iv1, iv2, iv3
+      real(r8) :: f_fp, f_fy, f_cfcst, mult, cff1, cff2
+      real(r8) :: f_gcf(NCS,NCS)
+!
+      f_fp=0.1_r8
+      f_fy=1e-10
+      f_cfcst=3.0_r8/16.0_r8
+      cff1=2.0_r8/(3.0_r8-f_nf)
+      cff2=1.0_r8/rhoref
+!
+!  f_gcf(iv2,iv3): collision shear number per Gval**2 for the breakup
+!  of floc iv3 colliding with floc iv2.
+!
+      DO iv3=1,NCS
+        DO iv2=1,NCS
+          f_gcf(iv2,iv3)=2.0_r8*(f_diam(iv2)+f_diam(iv3))**2.0_r8*      &
+     &                   f_mass(iv2)*f_mass(iv3)/(pi*f_fy*f_fp*         &
+     &                   f_diam(iv3)**2.0_r8*(f_mass(iv2)+f_mass(iv3))* &
+     &                   ((f_rho(iv3)-rhoref)*cff2)**cff1)
+        END DO
+      END DO
+      DO iv3=1,NCS
+        DO iv2=1,NCS
+          f_gcf_min(iv2,iv3)=f_gcf(iv2,iv3)
+          f_gcf_max(iv2,iv3)=f_gcf(iv3,iv2)
+        END DO
+      END DO
+!
+!  Gain: fragments of the pair (iv2,iv3), iv3 >= iv2.
+!
+      f_g4_one=0.0_r8
+      f_g4_both=0.0_r8
+      DO iv1=1,NCS
+        DO iv2=1,NCS
+          DO iv3=iv2,NCS
+!
+!  Larger floc breaks: iv3+f_cfcst*iv2 and iv2-f_cfcst*iv2.
+!
+            f_g4_one(iv2,iv3,iv1)=                                      &
+     &          collfrag_gain(iv1, f_mass(iv3)+f_cfcst*f_mass(iv2))+    &
+     &          collfrag_gain(iv1, f_mass(iv2)-f_cfcst*f_mass(iv2))
+!
+!  Both flocs break: f_cfcst*(iv2+iv3), (1-f_cfcst)*iv2 and
+!  (1-f_cfcst)*iv3.
+!
+            f_g4_both(iv2,iv3,iv1)=                                     &
+     &          collfrag_gain(iv1, f_cfcst*f_mass(iv2)+                 &
+     &                             f_cfcst*f_mass(iv3))+                &
+     &          collfrag_gain(iv1, (1.0_r8-f_cfcst)*f_mass(iv2))+       &
+     &          collfrag_gain(iv1, (1.0_r8-f_cfcst)*f_mass(iv3))
+            f_g4_one(iv2,iv3,iv1)=f_g4_one(iv2,iv3,iv1)*                &
+     &                            f_coll_prob_sh(iv2,iv3)*              &
+     &                            f_collfragparam
+            f_g4_both(iv2,iv3,iv1)=f_g4_both(iv2,iv3,iv1)*              &
+     &                             f_coll_prob_sh(iv2,iv3)*             &
+     &                             f_collfragparam
+          END DO
+        END DO
+      END DO
+!
+!  Loss: class iv1 is lost when it is the larger floc of the pair and
+!  breaks, or the smaller one and the larger breaks.
+!
+      DO iv1=1,NCS
+        DO iv2=1,NCS
+          mult=1.0_r8
+          IF (iv1.eq.iv2) mult=2.0_r8
+          f_l4(iv2,iv1)=mult*f_coll_prob_sh(iv1,iv2)*f_collfragparam
+          IF (iv1.ge.iv2) THEN
+            f_gcf_l4(iv2,iv1)=f_gcf(iv2,iv1)
+          ELSE
+            f_gcf_l4(iv2,iv1)=f_gcf(iv1,iv2)
+          END IF
+        END DO
+      END DO
+
+      RETURN
+
+      CONTAINS
+!
+!  Fraction of a fragment of mass fmf that goes to class iv, times
+!  fmf/f_mass(iv).
+!
+      FUNCTION collfrag_gain (iv, fmf) RESULT (gain)
+      integer,  intent(in) :: iv
+      real(r8), intent(in) :: fmf
+      real(r8) :: gain, f_weight
+
+      IF ((fmf.gt.f_mass(iv-1)).and.(fmf.le.f_mass(iv))) THEN
+        f_weight=(fmf-f_mass(iv-1))/(f_mass(iv)-f_mass(iv-1))
+      ELSE IF ((fmf.gt.f_mass(iv)).and.(fmf.lt.f_mass(iv+1))) THEN
+        IF (iv.eq.NCS) THEN
+          f_weight=1.0_r8
+        ELSE
+          f_weight=1.0_r8-(fmf-f_mass(iv))/(f_mass(iv+1)-f_mass(iv))
+        END IF
+      ELSE
+        f_weight=0.0_r8
+      END IF
+      gain=f_weight*fmf/f_mass(iv)
+
+      END FUNCTION collfrag_gain
+
+      END SUBROUTINE initialize_sedflocs_collfrag
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 
 #ifdef _UNDERSCORE
 #define read_geogrid read_geogrid_
@@ -37,7 +38,9 @@ int read_geogrid(
       int * status)
 {
    size_t i, cnt, narray;
-   int ival;
+   int ival, sign_adjust;
+   uint32_t uval;
+   float scale;
    int A2, B2;
    int A3, B3, C3;
    int A4, B4, C4, D4;
@@ -88,53 +91,64 @@ int read_geogrid(
       D4 = 0; C4 = 1; B4 = 2; A4 = 3;
    }
 
-   /* Convert words from native byte order */
+   /* 
+      Convert words from the file byte order, apply the sign convention, and
+      scale by scalefactor in a single pass over the data. The sign adjustment
+      is done with a mask rather than a branch, and the loops for signed and
+      unsigned 4-byte words are separate, so that compilers can vectorize
+      each of the loops below.
+   */
+   scale = *scalefactor;
    switch(*wordsize) {
       case 1:
+         sign_adjust = (*isigned) ? (1 << 8) : 0;
          for(i=0; i<narray; i++)
          {
             ival = (int)(c[i]);      
-            if ((*isigned) && (ival > (1 << 7))) ival -= (1 << 8);
-            rarray[i] = (float)ival;
+            ival -= sign_adjust & -(ival > (1 << 7));
+            rarray[i] = (float)ival * scale;
          }
          break;
 
       case 2:
+         sign_adjust = (*isigned) ? (1 << 16) : 0;
          for(i=0; i<narray; i++)
          {
             ival = (int)((c[2*i+A2]<<8) | (c[2*i+B2]));      
-            if ((*isigned) && (ival > (1 << 15))) ival -= (1 << 16);
-            rarray[i] = (float)ival;
+            ival -= sign_adjust & -(ival > (1 << 15));
+            rarray[i] = (float)ival * scale;
          }
          break;
 
       case 3:
+         sign_adjust = (*isigned) ? (1 << 24) : 0;
          for(i=0; i<narray; i++)
          {
             ival = (int)((c[3*i+A3]<<16) | (c[3*i+B3]<<8) | c[3*i+C3]);      
-            if ((*isigned) * (ival > (1 << 23))) ival -= (1 << 24);
-            rarray[i] = (float)ival;
+            ival -= sign_adjust & -(ival > (1 << 23));
+            rarray[i] = (float)ival * scale;
          }
          break;
 
       case 4:
-         for(i=0; i<narray; i++)
-         {
-            ival = (int)((c[4*i+A4]<<24) | (c[4*i+B4]<<16) | (c[4*i+C4]<<8) | c[4*i+D4]);      
-            if ((*isigned) && (ival > (1 << 31))) ival -= (1 << 32);
-            rarray[i] = (float)ival;
+         if (*isigned) {
+            for(i=0; i<narray; i++)
+            {
+               uval = ((uint32_t)c[4*i+A4]<<24) | ((uint32_t)c[4*i+B4]<<16) | ((uint32_t)c[4*i+C4]<<8) | (uint32_t)c[4*i+D4];
+               rarray[i] = (float)((int32_t)uval) * scale;
+            }
+         }
+         else {
+            for(i=0; i<narray; i++)
+            {
+               uval = ((uint32_t)c[4*i+A4]<<24) | ((uint32_t)c[4*i+B4]<<16) | ((uint32_t)c[4*i+C4]<<8) | (uint32_t)c[4*i+D4];
+               rarray[i] = (float)uval * scale;
+            }
          }
          break;
    }
 
    free(c);
 
-   /* Scale real-valued array by scalefactor */
-   if (*scalefactor != 1.0)
-   {
-      for (i=0; i<narray; i++)
-         rarray[i] = rarray[i] * (*scalefactor);
-   }
-
    return 0;
 }
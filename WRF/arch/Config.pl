@@ -598,6 +598,10 @@ while ( <CONFIGURE_DEFAULTS> )
              if ( /(^ARCH_LOCAL.*=|^TRADFLAG.*=)/ ) 
                { $_  =~ s/\r|\n//g; 
                  $_ .= " \$\(NETCDF4_IO_OPTS\)\n" ; 
+                 if ( $ENV{NETCDF4_PARALLEL} eq "1" )
+                   { $_  =~ s/\r|\n//g;
+                     $_ .= " \$\(NETCDF4_PAR_OPTS\)\n" ;
+                   }
                }
              if (/^LIB.*=/) 
                { $_  =~ s/\r|\n//g ;
@@ -0,0 +1,670 @@
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Block (multi-cell) version of the WRF conform Rosenbrock integrator.
+!  Generated when the mechanism sets #BLOCKCELLS; integrates NBLOCK
+!  grid cells at once with the cell index innermost in all arrays:
+!
+!     VAR(NBLOCK,NVAR), FIX(NBLOCK,NFIX), RCONST(NBLOCK,NREACT)
+!
+!  Every cell keeps its own time, step size and accept/reject history,
+!  and cells which are done (or failed) are masked out, so each cell
+!  takes exactly the steps the scalar integrator would take for it.
+!  The ODE function, Jacobian and sparse LU routines (_Blk) are
+!  generated by KPP as straight-line code over the whole block.
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+SUBROUTINE  KPP_ROOT_INTEGRATE_BLK( TIN, TOUT, NCELL, &
+  FIX, VAR,  RCONST, ATOL, RTOL, IRR_WRK,  &
+  ICNTRL_U, RCNTRL_U, ISTATUS_U, RSTATUS_U, IERR_U  )
+
+   USE KPP_ROOT_Parameters
+   IMPLICIT NONE
+!~~~> Number of valid cells in the block (1..NBLOCK); the remaining
+!     cells are filled with copies of the last valid one
+   INTEGER, INTENT(IN) :: NCELL
+   KPP_REAL, INTENT(INOUT), DIMENSION(NBLOCK,NFIX) :: FIX
+   KPP_REAL, INTENT(INOUT), DIMENSION(NBLOCK,NVAR) :: VAR
+   KPP_REAL, INTENT(INOUT) :: IRR_WRK(NBLOCK,NREACT)
+   KPP_REAL, INTENT(IN), DIMENSION(NSPEC) :: ATOL, RTOL
+   KPP_REAL, INTENT(INOUT), DIMENSION(NBLOCK,NREACT) :: RCONST
+   KPP_REAL, INTENT(IN) :: TIN  ! Start Time
+   KPP_REAL, INTENT(IN) :: TOUT ! End Time
+   ! Optional input parameters and statistics
+   INTEGER,  INTENT(IN),  OPTIONAL :: ICNTRL_U(20)
+   KPP_REAL, INTENT(IN),  OPTIONAL :: RCNTRL_U(20)
+   INTEGER,  INTENT(OUT), OPTIONAL :: ISTATUS_U(20)
+   KPP_REAL, INTENT(OUT), OPTIONAL :: RSTATUS_U(20)
+   INTEGER,  INTENT(OUT), OPTIONAL :: IERR_U(NBLOCK)
+
+   INTEGER :: i
+   INTEGER :: IERR(NBLOCK)
+   KPP_REAL :: RCNTRL(20), RSTATUS(20)
+   INTEGER :: ICNTRL(20), ISTATUS(20)
+
+
+   ICNTRL(:)  = 0
+   RCNTRL(:)  = 0.0_dp
+   ISTATUS(:) = 0
+   RSTATUS(:) = 0.0_dp
+
+   ! If optional parameters are given, and if they are >0,
+   ! then they overwrite default settings.
+   IF (PRESENT(ICNTRL_U)) THEN
+     WHERE(ICNTRL_U(:) > 0) ICNTRL(:) = ICNTRL_U(:)
+   END IF
+   IF (PRESENT(RCNTRL_U)) THEN
+     WHERE(RCNTRL_U(:) > 0) RCNTRL(:) = RCNTRL_U(:)
+   END IF
+
+   ! Keep the unused cells of a partial block finite
+   DO i = NCELL+1, NBLOCK
+     VAR(i,:)    = VAR(NCELL,:)
+     FIX(i,:)    = FIX(NCELL,:)
+     RCONST(i,:) = RCONST(NCELL,:)
+   END DO
+
+   CALL KPP_ROOT_Rosenbrock_Blk(NCELL, VAR, FIX, RCONST, TIN,TOUT,   &
+         ATOL,RTOL,               &
+         RCNTRL,ICNTRL,RSTATUS,ISTATUS,IRR_WRK,IERR)
+
+   ! if optional parameters are given for output they to return information
+   IF (PRESENT(ISTATUS_U)) ISTATUS_U(:) = ISTATUS(:)
+   IF (PRESENT(RSTATUS_U)) RSTATUS_U(:) = RSTATUS(:)
+   IF (PRESENT(IERR_U))    IERR_U(:)    = IERR(:)
+
+END SUBROUTINE  KPP_ROOT_INTEGRATE_BLK
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE  KPP_ROOT_Rosenbrock_Blk(NCELL, Y, FIX, RCONST, Tstart,Tend, &
+           AbsTol,RelTol,            &
+           RCNTRL,ICNTRL,RSTATUS,ISTATUS,IRR_WRK,IERR)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!
+!    Block version of KPP_ROOT_Rosenbrock: same method, same ICNTRL and
+!    RCNTRL settings, applied to the NCELL first cells of Y(NBLOCK,NVAR).
+!
+!~~~>     OUTPUT PARAMETERS (differences to the scalar version):
+!
+!    ISTATUS(1:8) count block operations (one function call evaluates
+!                 the whole block), except ISTATUS(3:5) which are the
+!                 largest numbers of steps taken by a single cell
+!    RSTATUS(1:2) -> smallest Texit and Hexit over the cells
+!    IERR(NBLOCK) -> job status of each cell
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  USE KPP_ROOT_Parameters
+  IMPLICIT NONE
+
+!~~~>  Arguments
+   INTEGER, INTENT(IN)    :: NCELL
+   KPP_REAL, INTENT(INOUT) :: Y(NBLOCK,NVAR)
+   KPP_REAL, INTENT(INOUT) :: IRR_WRK(NBLOCK,NREACT)
+   KPP_REAL, INTENT(IN), DIMENSION(NBLOCK,NFIX) :: FIX
+   KPP_REAL, INTENT(IN), DIMENSION(NBLOCK,NREACT) :: RCONST
+   KPP_REAL, INTENT(IN)   :: Tstart,Tend
+   KPP_REAL, INTENT(IN)   :: AbsTol(NVAR),RelTol(NVAR)
+   INTEGER, INTENT(IN)    :: ICNTRL(20)
+   KPP_REAL, INTENT(IN)   :: RCNTRL(20)
+   INTEGER, INTENT(INOUT) :: ISTATUS(20)
+   KPP_REAL, INTENT(INOUT) :: RSTATUS(20)
+   INTEGER, INTENT(OUT)   :: IERR(NBLOCK)
+!~~~>  The method parameters
+   INTEGER, PARAMETER :: Smax = 6
+   INTEGER  :: Method, ros_S
+   KPP_REAL, DIMENSION(Smax) :: ros_M, ros_E, ros_Alpha, ros_Gamma
+   KPP_REAL, DIMENSION(Smax*(Smax-1)/2) :: ros_A, ros_C
+   KPP_REAL :: ros_ELO
+   LOGICAL, DIMENSION(Smax) :: ros_NewF
+   CHARACTER(LEN=12) :: ros_Name
+
+!~~~>  Statistics on the work performed by the Rosenbrock method
+  INTEGER :: Nfun,Njac,Ndec,Nsol,Nsng
+  INTEGER :: Nstp(NBLOCK),Nacc(NBLOCK),Nrej(NBLOCK)
+
+!~~~>  Local variables
+   KPP_REAL :: Roundoff, FacMin, FacMax, FacRej, FacSafe
+   KPP_REAL :: Hmin, Hmax, Hstart
+   KPP_REAL :: Texit(NBLOCK), Hexit(NBLOCK)
+   INTEGER :: i, UplimTol, Max_no_steps
+   LOGICAL :: Autonomous, VectorTol
+!~~~>   Parameters
+   KPP_REAL, PARAMETER :: ZERO = 0.0_dp, ONE  = 1.0_dp
+   KPP_REAL, PARAMETER :: DeltaMin = 1.0E-5_dp
+
+!~~~>  Initialize statistics
+   Nfun = ISTATUS(ifun)
+   Njac = ISTATUS(ijac)
+   Ndec = ISTATUS(idec)
+   Nsol = ISTATUS(isol)
+   Nsng = ISTATUS(isng)
+   Nstp(:) = 0
+   Nacc(:) = 0
+   Nrej(:) = 0
+   IERR(:) = 0
+
+!~~~>  Autonomous or time dependent ODE. Default is time dependent.
+   Autonomous = .NOT.(ICNTRL(1) == 0)
+
+!~~~>  For Scalar tolerances (ICNTRL(2).NE.0)  the code uses AbsTol(1) and RelTol(1)
+!   For Vector tolerances (ICNTRL(2) == 0) the code uses AbsTol(1:NVAR) and RelTol(1:NVAR)
+   IF (ICNTRL(2) == 0) THEN
+      VectorTol = .TRUE.
+         UplimTol  = NVAR
+   ELSE
+      VectorTol = .FALSE.
+         UplimTol  = 1
+   END IF
+
+!~~~>  The particular Rosenbrock method chosen
+   IF (ICNTRL(3) == 0) THEN
+      Method = 4
+   ELSEIF ( (ICNTRL(3) >= 1).AND.(ICNTRL(3) <= 5) ) THEN
+      Method = ICNTRL(3)
+   ELSE
+      PRINT * , 'User-selected Rosenbrock method: ICNTRL(3)=', ICNTRL(3)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-2,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+
+!~~~>   The maximum number of steps admitted
+   IF (ICNTRL(4) == 0) THEN
+      Max_no_steps = 100000
+   ELSEIF (ICNTRL(4) > 0) THEN
+      Max_no_steps=ICNTRL(4)
+   ELSE
+      PRINT * ,'User-selected max no. of steps: ICNTRL(4)=',ICNTRL(4)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-1,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+
+!~~~>  Unit roundoff (1+Roundoff>1)
+   Roundoff = KPP_ROOT_WLAMCH('E')
+
+!~~~>  Lower bound on the step size: (positive value)
+   IF (RCNTRL(1) == ZERO) THEN
+      Hmin = ZERO
+   ELSEIF (RCNTRL(1) > ZERO) THEN
+      Hmin = RCNTRL(1)
+   ELSE
+      PRINT * , 'User-selected Hmin: RCNTRL(1)=', RCNTRL(1)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-3,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+!~~~>  Upper bound on the step size: (positive value)
+   IF (RCNTRL(2) == ZERO) THEN
+      Hmax = ABS(Tend-Tstart)
+   ELSEIF (RCNTRL(2) > ZERO) THEN
+      Hmax = MIN(ABS(RCNTRL(2)),ABS(Tend-Tstart))
+   ELSE
+      PRINT * , 'User-selected Hmax: RCNTRL(2)=', RCNTRL(2)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-3,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+!~~~>  Starting step size: (positive value)
+   IF (RCNTRL(3) == ZERO) THEN
+      Hstart = MAX(Hmin,DeltaMin)
+   ELSEIF (RCNTRL(3) > ZERO) THEN
+      Hstart = MIN(ABS(RCNTRL(3)),ABS(Tend-Tstart))
+   ELSE
+      PRINT * , 'User-selected Hstart: RCNTRL(3)=', RCNTRL(3)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-3,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+!~~~>  Step size can be changed s.t.  FacMin < Hnew/Hexit < FacMax
+   IF (RCNTRL(4) == ZERO) THEN
+      FacMin = 0.2_dp
+   ELSEIF (RCNTRL(4) > ZERO) THEN
+      FacMin = RCNTRL(4)
+   ELSE
+      PRINT * , 'User-selected FacMin: RCNTRL(4)=', RCNTRL(4)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-4,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+   IF (RCNTRL(5) == ZERO) THEN
+      FacMax = 6.0_dp
+   ELSEIF (RCNTRL(5) > ZERO) THEN
+      FacMax = RCNTRL(5)
+   ELSE
+      PRINT * , 'User-selected FacMax: RCNTRL(5)=', RCNTRL(5)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-4,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+!~~~>   FacRej: Factor to decrease step after 2 succesive rejections
+   IF (RCNTRL(6) == ZERO) THEN
+      FacRej = 0.1_dp
+   ELSEIF (RCNTRL(6) > ZERO) THEN
+      FacRej = RCNTRL(6)
+   ELSE
+      PRINT * , 'User-selected FacRej: RCNTRL(6)=', RCNTRL(6)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-4,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+!~~~>   FacSafe: Safety Factor in the computation of new step size
+   IF (RCNTRL(7) == ZERO) THEN
+      FacSafe = 0.9_dp
+   ELSEIF (RCNTRL(7) > ZERO) THEN
+      FacSafe = RCNTRL(7)
+   ELSE
+      PRINT * , 'User-selected FacSafe: RCNTRL(7)=', RCNTRL(7)
+      CALL KPP_ROOT_ros_ErrorMsg_Blk(-4,Tstart,ZERO,IERR)
+      RETURN
+   END IF
+!~~~>  Check if tolerances are reasonable
+    DO i=1,UplimTol
+      IF ( (AbsTol(i) <= ZERO) .OR. (RelTol(i) <= 10.0_dp*Roundoff) &
+         .OR. (RelTol(i) >= 1.0_dp) ) THEN
+        PRINT * , ' AbsTol(',i,') = ',AbsTol(i)
+        PRINT * , ' RelTol(',i,') = ',RelTol(i)
+        CALL KPP_ROOT_ros_ErrorMsg_Blk(-5,Tstart,ZERO,IERR)
+        RETURN
+      END IF
+    END DO
+
+
+!~~~>   Initialize the particular Rosenbrock method
+   SELECT CASE (Method)
+     CASE (1)
+       CALL KPP_ROOT_Ros2(ros_S, ros_A, ros_C, ros_M, ros_E,   &
+          ros_Alpha, ros_Gamma, ros_NewF, ros_ELO, ros_Name)
+     CASE (2)
+       CALL KPP_ROOT_Ros3(ros_S, ros_A, ros_C, ros_M, ros_E,   &
+          ros_Alpha, ros_Gamma, ros_NewF, ros_ELO, ros_Name)
+     CASE (3)
+       CALL KPP_ROOT_Ros4(ros_S, ros_A, ros_C, ros_M, ros_E,   &
+          ros_Alpha, ros_Gamma, ros_NewF, ros_ELO, ros_Name)
+     CASE (4)
+       CALL KPP_ROOT_Rodas3(ros_S, ros_A, ros_C, ros_M, ros_E, &
+          ros_Alpha, ros_Gamma, ros_NewF, ros_ELO, ros_Name)
+     CASE (5)
+       CALL KPP_ROOT_Rodas4(ros_S, ros_A, ros_C, ros_M, ros_E, &
+          ros_Alpha, ros_Gamma, ros_NewF, ros_ELO, ros_Name)
+   END SELECT
+
+!~~~>  CALL Rosenbrock method
+   CALL KPP_ROOT_ros_Integrator_Blk(NCELL, Y,Tstart,Tend,Texit, &
+        AbsTol, RelTol,                          &
+!  Rosenbrock method coefficients
+        ros_S, ros_M, ros_E, ros_A, ros_C,       &
+        ros_Alpha, ros_Gamma, ros_ELO, ros_NewF, &
+!  Integration parameters
+        Autonomous, VectorTol, Max_no_steps,     &
+        Roundoff, Hmin, Hmax, Hstart, Hexit,     &
+        FacMin, FacMax, FacRej, FacSafe,         &
+!  Error indicator
+        IRR_WRK,IERR,                            &
+!  Statistics on the work performed by the Rosenbrock method
+         Nfun,Njac,Nstp,Nacc,Nrej,Ndec,Nsol,Nsng,&
+!~~~>
+         RCONST, FIX &
+)
+
+
+!~~~>  Collect run statistics
+   ISTATUS(ifun) = Nfun
+   ISTATUS(ijac) = Njac
+   ISTATUS(istp) = ISTATUS(istp) + MAXVAL(Nstp(1:NCELL))
+   ISTATUS(iacc) = ISTATUS(iacc) + MAXVAL(Nacc(1:NCELL))
+   ISTATUS(irej) = ISTATUS(irej) + MAXVAL(Nrej(1:NCELL))
+   ISTATUS(idec) = Ndec
+   ISTATUS(isol) = Nsol
+   ISTATUS(isng) = Nsng
+!~~~> Last T and H
+   RSTATUS(itexit) = MINVAL(Texit(1:NCELL))
+   RSTATUS(ihexit) = MINVAL(Hexit(1:NCELL))
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+CONTAINS !  SUBROUTINES internal to Rosenbrock_Blk
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ SUBROUTINE  KPP_ROOT_ros_ErrorMsg_Blk(Code,T,H,IERR)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!    Handles all error messages; sets the error code of the given cells
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   USE KPP_ROOT_Precision
+
+   KPP_REAL, INTENT(IN) :: T, H
+   INTEGER, INTENT(IN)  :: Code
+   INTEGER, INTENT(OUT) :: IERR(:)
+
+   IERR(:) = Code
+   PRINT * , &
+     'Forced exit from Rosenbrock_Blk due to the following error:'
+   IF ((Code>=-8).AND.(Code<=-1)) THEN
+     PRINT *, IERR_NAMES(Code)
+   ELSE
+     PRINT *, 'Unknown Error code: ', Code
+   ENDIF
+
+   PRINT *, "T=", T, "and H=", H
+
+ END SUBROUTINE  KPP_ROOT_ros_ErrorMsg_Blk
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ SUBROUTINE  KPP_ROOT_ros_Integrator_Blk (NCELL, Y, Tstart, Tend, T, &
+        AbsTol, RelTol,                          &
+!~~~> Rosenbrock method coefficients
+        ros_S, ros_M, ros_E, ros_A, ros_C,       &
+        ros_Alpha, ros_Gamma, ros_ELO, ros_NewF, &
+!~~~> Integration parameters
+        Autonomous, VectorTol, Max_no_steps,     &
+        Roundoff, Hmin, Hmax, Hstart, Hexit,     &
+        FacMin, FacMax, FacRej, FacSafe,         &
+!~~~> Error indicator
+        IRR_WRK,IERR,                            &
+!~~~>   Statistics on the work performed by the Rosenbrock method
+        Nfun,Njac,Nstp,Nacc,Nrej,Ndec,Nsol,Nsng, &
+!~~~>
+        RCONST, FIX )
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!   Template for the implementation of a generic Rosenbrock method
+!      on a block of cells.  Each pass of the time loop makes one step
+!      attempt for every cell that is still active: the rates and the
+!      Jacobian are evaluated for the whole block, and the step is then
+!      accepted or rejected cell by cell.
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  IMPLICIT NONE
+
+!~~~> Number of valid cells
+   INTEGER, INTENT(IN) :: NCELL
+!~~~> Input: the initial condition at Tstart; Output: the solution at T
+   KPP_REAL, INTENT(INOUT) :: Y(NBLOCK,NVAR)
+!~~~> Output: the reaction rates
+   KPP_REAL, INTENT(INOUT) :: IRR_WRK(NBLOCK,NREACT)
+!~~~> Input: integration interval
+   KPP_REAL, INTENT(IN) :: Tstart,Tend
+!~~~> Output: time at which the solution is returned (T=Tend if success)
+   KPP_REAL, INTENT(OUT) ::  T(NBLOCK)
+!~~~> Input: tolerances
+   KPP_REAL, INTENT(IN) ::  AbsTol(NVAR), RelTol(NVAR)
+!~~~> Input: The Rosenbrock method parameters
+   INTEGER, INTENT(IN) ::  ros_S
+   KPP_REAL, INTENT(IN) :: ros_M(ros_S), ros_E(ros_S),  &
+       ros_Alpha(ros_S), ros_A(ros_S*(ros_S-1)/2), &
+       ros_Gamma(ros_S), ros_C(ros_S*(ros_S-1)/2), ros_ELO
+   LOGICAL, INTENT(IN) :: ros_NewF(ros_S)
+!~~~> Input: integration parameters
+   LOGICAL, INTENT(IN) :: Autonomous, VectorTol
+   KPP_REAL, INTENT(IN) :: Hstart, Hmin, Hmax
+   INTEGER, INTENT(IN) :: Max_no_steps
+   KPP_REAL, INTENT(IN) :: Roundoff, FacMin, FacMax, FacRej, FacSafe
+!~~~> Output: last accepted step
+   KPP_REAL, INTENT(OUT) :: Hexit(NBLOCK)
+!~~~> Output: Error indicator
+   INTEGER, INTENT(OUT) :: IERR(NBLOCK)
+!~~~> Input
+   KPP_REAL, INTENT(IN), DIMENSION(NBLOCK,NFIX) :: FIX
+!~~~> Input
+   KPP_REAL, INTENT(IN), DIMENSION(NBLOCK,NREACT) :: RCONST
+
+!~~~>  Statistics on the work performed by the Rosenbrock method
+  INTEGER, INTENT(INOUT)  :: Nfun,Njac,Ndec,Nsol,Nsng
+  INTEGER, INTENT(INOUT)  :: Nstp(NBLOCK),Nacc(NBLOCK),Nrej(NBLOCK)
+
+! ~~~~ Local variables
+   KPP_REAL :: Ynew(NBLOCK,NVAR), Fcn0(NBLOCK,NVAR), Fcn(NBLOCK,NVAR)
+   KPP_REAL :: K(NBLOCK,NVAR,ros_S), dFdT(NBLOCK,NVAR)
+   KPP_REAL :: Jac0(NBLOCK,LU_NONZERO), Ghimj(NBLOCK,LU_NONZERO)
+   KPP_REAL :: H(NBLOCK), Hnew, HC(NBLOCK), HG(NBLOCK), Fac
+   KPP_REAL :: Err(NBLOCK), Yerr(NBLOCK,NVAR), Delta(NBLOCK)
+   INTEGER :: Direction, j, istage, iv, it, ic
+   LOGICAL :: Active(NBLOCK), RejectLastH(NBLOCK), RejectMoreH(NBLOCK)
+   LOGICAL :: NewY
+!~~~>  Local parameters
+   KPP_REAL, PARAMETER :: ZERO = 0.0_dp, ONE  = 1.0_dp
+   KPP_REAL, PARAMETER :: DeltaMin = 1.0E-5_dp, DeltaMinT = 1.0E-6_dp
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+
+!~~~>  Initial preparations
+   T(:) = Tstart
+   Hexit(:) = 0.0_dp
+   H(:) = MIN(Hstart,Hmax)
+   IF (ABS(H(1)) <= 10.0_dp*Roundoff) H(:) = DeltaMin
+
+   IF (Tend  >=  Tstart) THEN
+     Direction = +1
+   ELSE
+     Direction = -1
+   END IF
+
+   RejectLastH(:) = .FALSE.
+   RejectMoreH(:) = .FALSE.
+   Active(:) = .FALSE.
+   Active(1:NCELL) = .TRUE.
+   NewY = .TRUE.
+
+!~~~>  Reaction rates at the initial state
+   CALL KPP_ROOT_IRRFun_Blk( Y, FIX, RCONST, IRR_WRK )
+
+!~~~> Time loop: one step attempt per active cell
+
+TimeLoop: DO
+
+   DO ic = 1, NCELL
+!~~~>  Cells retrying a rejected step skip the checks, as in the scalar code
+     IF ( .NOT.Active(ic) .OR. RejectLastH(ic) ) CYCLE
+     IF ( .NOT.( (Direction > 0).AND.((T(ic)-Tend)+Roundoff <= ZERO) &
+        .OR. (Direction < 0).AND.((Tend-T(ic))+Roundoff <= ZERO) ) ) THEN
+        Active(ic) = .FALSE.   ! Done
+        IERR(ic) = 1
+        CYCLE
+     END IF
+     IF ( Nstp(ic) > Max_no_steps ) THEN  ! Too many steps
+        CALL KPP_ROOT_ros_ErrorMsg_Blk(-6,T(ic),H(ic),IERR(ic:ic))
+        Active(ic) = .FALSE.
+        CYCLE
+     END IF
+     IF ( ((T(ic)+0.1_dp*H(ic)) == T(ic)).OR.(H(ic) <= Roundoff) ) THEN  ! Step size too small
+        CALL KPP_ROOT_ros_ErrorMsg_Blk(-7,T(ic),H(ic),IERR(ic:ic))
+        Active(ic) = .FALSE.
+        CYCLE
+     END IF
+!~~~>  Limit H if necessary to avoid going beyond Tend
+     Hexit(ic) = H(ic)
+     H(ic) = MIN(H(ic),ABS(Tend-T(ic)))
+   END DO
+   IF ( .NOT.ANY(Active) ) EXIT TimeLoop
+
+!~~~>  Function and Jacobian are only recomputed if some cell has moved on;
+!      a pass in which all cells retry a rejected step reuses them
+   IF ( NewY ) THEN
+
+!~~~>   Compute the function at current time
+   CALL KPP_ROOT_Fun_Blk( Y, FIX, RCONST, Fcn0 )
+   Nfun = Nfun+1
+
+!~~~>  Compute the function derivative with respect to T
+   IF (.NOT.Autonomous) THEN
+      Delta(:) = SQRT(Roundoff)*MAX(DeltaMinT,ABS(T(:)))
+      CALL KPP_ROOT_Fun_Blk( Y, FIX, RCONST, dFdT )
+      Nfun = Nfun+1
+      DO iv = 1, NVAR
+        dFdT(:,iv) = (dFdT(:,iv) - Fcn0(:,iv))*(ONE/Delta(:))
+      END DO
+   END IF
+
+!~~~>   Compute the Jacobian at current time
+   CALL KPP_ROOT_Jac_SP_Blk( Y, FIX, RCONST, Jac0 )
+   Njac = Njac+1
+
+   END IF
+
+   CALL KPP_ROOT_ros_PrepareMatrix_Blk(H,Direction,ros_Gamma(1), &
+          Jac0,Ghimj,Active,IERR,Ndec,Nsng)
+   IF ( .NOT.ANY(Active) ) EXIT TimeLoop
+
+!~~~>   Compute the stages
+Stage: DO istage = 1, ros_S
+
+      ! For the 1st istage the function has been computed previously
+       IF ( istage == 1 ) THEN
+         Fcn(:,:) = Fcn0(:,:)
+      ! istage>1 and a new function evaluation is needed at the current istage
+       ELSEIF ( ros_NewF(istage) ) THEN
+         Ynew(:,:) = Y(:,:)
+         DO j = 1, istage-1
+           DO iv = 1, NVAR
+             Ynew(:,iv) = Ynew(:,iv) +                              &
+                 ros_A((istage-1)*(istage-2)/2+j)*K(:,iv,j)
+           END DO
+         END DO
+         CALL KPP_ROOT_Fun_Blk( Ynew, FIX, RCONST, Fcn )
+         Nfun = Nfun+1
+       END IF ! if istage == 1 elseif ros_NewF(istage)
+       K(:,:,istage) = Fcn(:,:)
+       DO j = 1, istage-1
+         HC(:) = ros_C((istage-1)*(istage-2)/2+j)/(Direction*H(:))
+         DO iv = 1, NVAR
+           K(:,iv,istage) = K(:,iv,istage) + HC(:)*K(:,iv,j)
+         END DO
+       END DO
+       IF ((.NOT. Autonomous).AND.(ros_Gamma(istage).NE.ZERO)) THEN
+         HG(:) = Direction*H(:)*ros_Gamma(istage)
+         DO iv = 1, NVAR
+           K(:,iv,istage) = K(:,iv,istage) + HG(:)*dFdT(:,iv)
+         END DO
+       END IF
+       CALL KPP_ROOT_KppSolve_Blk( Ghimj, K(:,:,istage) )
+       Nsol = Nsol+1
+
+   END DO Stage
+
+
+!~~~>  Compute the new solution
+   Ynew(:,:) = Y(:,:)
+   DO j=1,ros_S
+     DO iv = 1, NVAR
+       Ynew(:,iv) = Ynew(:,iv) + ros_M(j)*K(:,iv,j)
+     END DO
+   END DO
+
+!~~~>  Compute the error estimation
+   Yerr(:,:) = ZERO
+   DO j=1,ros_S
+     DO iv = 1, NVAR
+       Yerr(:,iv) = Yerr(:,iv) + ros_E(j)*K(:,iv,j)
+     END DO
+   END DO
+   Err(:) = ZERO
+   DO iv = 1, NVAR
+     IF (VectorTol) THEN
+       it = iv
+     ELSE
+       it = 1
+     END IF
+     Err(:) = Err(:) + ( Yerr(:,iv) / ( AbsTol(it) + RelTol(it)*   &
+                MAX(ABS(Y(:,iv)),ABS(Ynew(:,iv))) ) )**2
+   END DO
+   Err(:) = SQRT(Err(:)/NVAR)
+
+!~~~>  Accept or reject the step of each active cell
+   NewY = .FALSE.
+   DO ic = 1, NCELL
+     IF ( .NOT.Active(ic) ) CYCLE
+
+!~~~> New step size is bounded by FacMin <= Hnew/H <= FacMax
+     Fac  = MIN(FacMax,MAX(FacMin,FacSafe/Err(ic)**(ONE/ros_ELO)))
+     Hnew = H(ic)*Fac
+
+!~~~>  Check the error magnitude and adjust step size
+     Nstp(ic) = Nstp(ic)+1
+     IF ( (Err(ic) <= ONE).OR.(H(ic) <= Hmin) ) THEN  !~~~> Accept step
+        Nacc(ic) = Nacc(ic)+1
+        Y(ic,:) = Ynew(ic,:)
+        NewY = .TRUE.
+        T(ic) = T(ic) + Direction*H(ic)
+        Hnew = MAX(Hmin,MIN(Hnew,Hmax))
+        IF (RejectLastH(ic)) THEN  ! No step size increase after a rejected step
+           Hnew = MIN(Hnew,H(ic))
+        END IF
+        RejectLastH(ic) = .FALSE.
+        RejectMoreH(ic) = .FALSE.
+        H(ic) = Hnew
+     ELSE           !~~~> Reject step
+        IF (RejectMoreH(ic)) THEN
+           Hnew = H(ic)*FacRej
+        END IF
+        RejectMoreH(ic) = RejectLastH(ic)
+        RejectLastH(ic) = .TRUE.
+        H(ic) = Hnew
+        IF (Nacc(ic) >= 1) THEN
+           Nrej(ic) = Nrej(ic)+1
+        END IF
+     END IF ! Err <= 1
+   END DO
+
+   END DO TimeLoop
+
+  END SUBROUTINE  KPP_ROOT_ros_Integrator_Blk
+
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  SUBROUTINE  KPP_ROOT_ros_PrepareMatrix_Blk ( H, Direction, gam, &
+             Jac0, Ghimj, Active, IERR, Ndec, Nsng )
+! --- --- --- --- --- --- --- --- --- --- --- --- ---
+!  Prepares the LHS matrices of the block for stage calculations
+!  1.  Construct Ghimj = 1/(H*gam) - Jac0 for every cell
+!  2.  Repeat LU decomposition of Ghimj until successful.
+!       -half the step size of the cells whose decomposition fails
+!       -drop a cell after 5 consecutive fails
+! --- --- --- --- --- --- --- --- --- --- --- --- ---
+   IMPLICIT NONE
+
+!~~~> Input arguments
+   KPP_REAL, INTENT(IN) ::  Jac0(NBLOCK,LU_NONZERO)
+   KPP_REAL, INTENT(IN) ::  gam
+   INTEGER, INTENT(IN) ::  Direction
+!~~~> Output arguments
+   KPP_REAL, INTENT(OUT) :: Ghimj(NBLOCK,LU_NONZERO)
+!~~~> Inout arguments
+   KPP_REAL, INTENT(INOUT) :: H(NBLOCK)   ! step size is decreased when LU fails
+   LOGICAL, INTENT(INOUT) :: Active(NBLOCK)
+   INTEGER, INTENT(INOUT) ::  IERR(NBLOCK), Ndec, Nsng
+!~~~> Local variables
+   INTEGER  :: i, ic, ising(NBLOCK), Nconsecutive(NBLOCK)
+   KPP_REAL :: ghinv(NBLOCK)
+   KPP_REAL, PARAMETER :: ONE  = 1.0_dp, HALF = 0.5_dp
+
+   Nconsecutive(:) = 0
+
+   DO
+
+!~~~>    Construct Ghimj = 1/(H*gam) - Jac0
+     Ghimj(:,:) = -Jac0(:,:)
+     ghinv(:) = ONE/(Direction*H(:)*gam)
+     DO i=1,NVAR
+       Ghimj(:,LU_DIAG(i)) = Ghimj(:,LU_DIAG(i))+ghinv(:)
+     END DO
+!~~~>    Compute LU decomposition
+     CALL KPP_ROOT_KppDecomp_Blk( Ghimj, ising )
+     Ndec = Ndec + 1
+     IF ( .NOT.ANY( Active(:) .AND. ising(:) /= 0 ) ) RETURN
+
+!~~~>    If unsuccessful half the step size; if 5 consecutive fails then drop the cell
+     Nsng = Nsng+1
+     DO ic = 1, NBLOCK
+       IF ( Active(ic) .AND. ising(ic) /= 0 ) THEN
+         PRINT*,'Warning: LU Decomposition returned ising = ',ising(ic)
+         Nconsecutive(ic) = Nconsecutive(ic)+1
+         IF (Nconsecutive(ic) <= 5) THEN ! Less than 5 consecutive failed decompositions
+           H(ic) = H(ic)*HALF
+         ELSE  ! More than 5 consecutive failed decompositions
+           Active(ic) = .FALSE.
+           IERR(ic) = -8
+           PRINT *, IERR_NAMES(-8)
+         END IF  ! Nconsecutive
+       END IF
+     END DO
+
+   END DO
+
+  END SUBROUTINE  KPP_ROOT_ros_PrepareMatrix_Blk
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!   End of the set of internal Rosenbrock_Blk subroutines
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+END SUBROUTINE  KPP_ROOT_Rosenbrock_Blk
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
@@ -102,6 +102,7 @@ FILE * wrf_UpdateRconstFile = 0;
 FILE * currentFile;
 
 int ident = 0;
+int blockMode = 0;  /* vectors carry a leading cell dimension (#BLOCKCELLS) */
 
 FILE * UseFile( FILE * file )
 {
@@ -81,6 +81,7 @@ extern FILE * wrf_UpdateRconstFile;
 extern FILE * currentFile;
 
 extern int ident;
+extern int blockMode;
 extern int real;
 extern char * CommonName;
 
@@ -63,7 +63,8 @@ char maxj[20];
 		break;
     case VELM:  if( elm->val.idx.i >= 0 ) sprintf( maxi, "%d", elm->val.idx.i+1 );
                   else sprintf( maxi, "%s", varTable[ -elm->val.idx.i ]->name );
-                bprintf("%s(%s)", name, maxi ); 
+                if( blockMode ) bprintf("%s(:,%s)", name, maxi );
+                  else bprintf("%s(%s)", name, maxi ); 
 		break;
     case MELM:  if( elm->val.idx.i >= 0 ) sprintf( maxi, "%d", elm->val.idx.i+1 );
                   else sprintf( maxi, "%s", varTable[ -elm->val.idx.i ]->name );
@@ -136,7 +137,7 @@ char op_mult=0xaa, op_plus=0xab, op_minus=0xad, op_dot=0xae, op_div=0xaf;
           Note: the approach below will create erroneous code if the +/- is within a subexpression, e.g. for
           A*(B+C) one cannot start a new continuation line by splitting at the + sign */
      for( j=linelg; j>5; j-- ) /* split row here if +, -, or comma */
-       if ( ( rs[j] == op_plus )||( rs[j] == op_minus )||( rs[j]==',' ) ) { 
+       if ( ( rs[j] == op_plus )||( rs[j] == op_minus )||( ( rs[j]==',' )&&( !blockMode ) ) ) { 
         jfound = 1; i=j; break;
 	}
     }
@@ -234,7 +235,12 @@ char maxj[20];
 		      sprintf( maxi, "%d", (varTable[-var->maxi]->value)==0?
 		           1:varTable[-var->maxi]->value );
 		}  
-                sprintf( buf, "%s :: %s(%s)", baseType, var->name, maxi );
+                if( blockMode && ( var->maxi == 0 ) ) /* one value per cell */
+                  sprintf( buf, "%s :: %s(NBLOCK)", baseType, var->name );
+                else if( blockMode )
+                  sprintf( buf, "%s :: %s(NBLOCK,%s)", baseType, var->name, maxi );
+                else
+                  sprintf( buf, "%s :: %s(%s)", baseType, var->name, maxi );
  		break;
     case MELM:  
                 if( var->maxi > 0 ) sprintf( maxi, "%d", var->maxi );
@@ -148,6 +148,7 @@ extern int useEqntags;
 extern int useLang;
 extern int useStochastic;
 extern int useWRFConform; 
+extern int useBlockCells;
 
 extern char Home[ MAX_PATH ];
 extern char integrator[ MAX_PATH ];
@@ -187,6 +188,7 @@ void CmdHessian( char *cmd );
 void CmdDouble( char *cmd );
 void CmdReorder( char *cmd );
 void CmdMex( char *cmd );
+void CmdBlockCells( char *cmd );
 void CmdDummyindex( char *cmd );
 void CmdEqntags( char *cmd );
 void CmdUse( char *cmd );
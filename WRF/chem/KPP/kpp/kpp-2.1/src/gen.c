@@ -73,6 +73,7 @@ int TIME, SUN, TEMP;
 int RTOLS, TSTART, TEND, DT;
 int ATOL, RTOL, STEPMIN, STEPMAX, CFACTOR;
 int V_USER, CL;
+int NBLOCK, IERB;
 int NMLCV, NMLCF, SCT, PROPENSITY, VOLUME, IRCT;
 
 int Jac_NZ, LU_Jac_NZ, nzr;
@@ -141,6 +142,7 @@ int i,j;
   NFIXST  = DefConst( "NFIXST",  INT, "Starting of fixed in conc. vect." );
   NONZERO = DefConst( "NONZERO", INT, "Number of nonzero entries in Jacobian" );
   LU_NONZERO = DefConst( "LU_NONZERO", INT, "Number of nonzero entries in LU factoriz. of Jacobian" );
+  NBLOCK  = DefConst( "NBLOCK",  INT, "Number of grid cells per block" );
   CNVAR   = DefConst( "CNVAR",   INT, "(NVAR+1) Number of elements in compressed row format" );
   CNEQN   = DefConst( "CNEQN",   INT, "(NREACT+1) Number stoicm elements in compressed col format" );
 
@@ -172,6 +174,7 @@ int i,j;
   JTUV  = DefvElm( "JTUV",real, -NVAR, "Jacobian transposed times user vector" );
 
   X     = DefvElm( "X",  real, -NVAR, "Vector for variables" );
+  IERB  = DefvElm( "IER", INT, 0, "Error flag of each cell" );
   XX    = DefvElm( "XX", real, -NVAR, "Vector for output variables" );
 
   TIME  = DefElm( "TIME", real, "Current integration time");
@@ -618,9 +621,9 @@ char buf1[100], buf2[100];
 
   if ( useWRFConform ) 
     {
-       sprintf( buf1, "%s_Fun", rootFileName ); 
+       sprintf( buf1, "%s_Fun%s", rootFileName, blockMode ? "_Blk" : "" ); 
   F_VAR      = DefFnc( buf1,      4, "time derivatives of variables - Agregate form");
-       sprintf( buf2, "%s_Fun_SPLIT", rootFileName ); 
+       sprintf( buf2, "%s_Fun_SPLIT%s", rootFileName, blockMode ? "_Blk" : "" ); 
   FSPLIT_VAR      = DefFnc( buf2,      4, "time derivatives of variables - Agregate form");
     }
   else
@@ -764,9 +767,9 @@ char buf1[100], buf2[100];
 
   if ( useWRFConform ) 
     {
-       sprintf( buf1, "%s_IRRFun", rootFileName ); 
+       sprintf( buf1, "%s_IRRFun%s", rootFileName, blockMode ? "_Blk" : "" ); 
   F_VAR      = DefFnc( buf1,      4, "accumulated time derivatives of variables - Agregate form");
-       sprintf( buf2, "%s_IRRFun_SPLIT", rootFileName ); 
+       sprintf( buf2, "%s_IRRFun_SPLIT%s", rootFileName, blockMode ? "_Blk" : "" ); 
   FSPLIT_VAR      = DefFnc( buf2,      4, "accumulated time derivatives of variables - Agregate form");
     }
   else
@@ -1106,10 +1109,10 @@ char buf1[100], buf2[100];
        UseFile( jacobianFile );
   
   if ( useWRFConform ){
-   sprintf( buf1, "%s_Jac_SP", rootFileName );  
+   sprintf( buf1, "%s_Jac_SP%s", rootFileName, blockMode ? "_Blk" : "" );  
   Jac_SP  = DefFnc( buf1, 4,
                   "the Jacobian of Variables in sparse matrix representation");
-   sprintf( buf2, "%s_Jac", rootFileName );
+   sprintf( buf2, "%s_Jac%s", rootFileName, blockMode ? "_Blk" : "" );
    Jac     = DefFnc( buf2, 4, "the Jacobian of Variables"); 
   }
   else 
@@ -1929,7 +1932,7 @@ char buf1[100];
 
   if ( useWRFConform ){
   UseFile( integratorFile );
-  sprintf( buf1, "%s_KppSolve", rootFileName ); 
+  sprintf( buf1, "%s_KppSolve%s", rootFileName, blockMode ? "_Blk" : "" ); 
   }else{  
   UseFile( linalgFile );
   sprintf( buf1, "KppSolve", rootFileName );
@@ -1971,6 +1974,103 @@ char buf1[100];
   free(diag); 
 }
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Unrolled sparse LU factorization of a block of cells (#BLOCKCELLS).        */
+/* Same operations, in the same order, as KppDecomp, but done in place: the   */
+/* positions of the fill-in of each row are known here, so no work vector is  */
+/* needed and every statement is a loop over the cells of the block.         */
+void GenerateBlockDecomp()
+{
+int i, j, k, jj, kk;
+int DECOMP;
+int *irow;
+int *icol;
+int *crow;
+int *diag;
+int *pos;
+int useLangOld;
+int dim;
+char buf1[100];
+
+  if( useLang != F90_LANG ) return;
+
+  /* Allocate local arrays for dimension dim */
+  dim  = VarNr+2;
+  irow = AllocIntegerVector( dim*dim, "irow in GenerateBlockDecomp" );
+  icol = AllocIntegerVector( dim*dim, "icol in GenerateBlockDecomp" );
+  crow = AllocIntegerVector( dim,     "crow in GenerateBlockDecomp" );
+  diag = AllocIntegerVector( dim,     "diag in GenerateBlockDecomp" );
+  pos  = AllocIntegerVector( dim,     "pos in GenerateBlockDecomp" );
+
+  useLangOld = useLang;
+  useLang = C_LANG;
+  NonZero( LU, 0, VarNr, irow, icol, crow, diag );
+  useLang = useLangOld;
+
+  UseFile( integratorFile );
+  sprintf( buf1, "%s_KppDecomp_Blk", rootFileName ); 
+  DECOMP = DefFnc( buf1, 2, "sparse LU factorization of a block of cells");
+  FunctionBegin( DECOMP, JVS, IERB );
+
+  F90_Inline("  IER(:) = 0");
+
+  for( k = 0; k < VarNr; k++ ) {
+    /* as in KppDecomp the pivot is checked before row k is eliminated; a
+       failed cell gets a unit pivot so that it stays finite */
+    NewLines(1);
+    F90_Inline("  WHERE ( ABS(JVS(:,%d)) < TINY(1.0_dp) )", diag[k]+1 );
+    F90_Inline("    IER(:) = MERGE( IER(:), %d, IER(:) > 0 )", k+1 );
+    F90_Inline("    JVS(:,%d) = 1.0_dp", diag[k]+1 );
+    F90_Inline("  END WHERE");
+
+    for( i = 0; i < VarNr; i++ ) pos[i] = -1;
+    for( kk = crow[k]; kk < crow[k+1]; kk++ ) pos[ icol[kk] ] = kk;
+
+    for( kk = crow[k]; kk < diag[k]; kk++ ) {
+      j = icol[kk];
+      Assign( Elm( JVS, kk ), Div( Elm( JVS, kk ), Elm( JVS, diag[j] ) ) );
+      for( jj = diag[j]+1; jj < crow[j+1]; jj++ ) {
+        i = pos[ icol[jj] ];
+        if( i < 0 )
+          FatalError(3,"GenerateBlockDecomp: no fill-in position for (%d,%d)",
+                     k+1, icol[jj]+1 );
+        Assign( Elm( JVS, i ), Sub( Elm( JVS, i ),
+                                    Mul( Elm( JVS, kk ), Elm( JVS, jj ) ) ) );
+      }
+    }
+  }
+
+  FunctionEnd( DECOMP );
+  FreeVariable( DECOMP );
+
+  /* Free Local Arrays */
+  free(irow); 
+  free(icol); 
+  free(crow); 
+  free(diag); 
+  free(pos); 
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Routines used by the block integrator (WRF conform only): the ODE          */
+/* function, reaction rates, sparse Jacobian, LU factorization and back       */
+/* substitution for NBLOCK cells, with the cell index innermost.              */
+void GenerateBlockRoutines()
+{
+  if( !useJacSparse ) {
+    printf("\nWarning: #BLOCKCELLS needs a sparse Jacobian, no block routines generated\n");
+    return;
+  }
+
+  blockMode = 1;
+  GenerateFun();
+  GenerateIRRFun();
+  GenerateJac();
+  GenerateBlockDecomp();
+  GenerateSolve();
+  blockMode = 0;
+}
+
 
 
 
@@ -2348,7 +2448,9 @@ int TIN, TOUT, INTEGRATE;
 
     if ( useWRFConform ){
     printf( "\n \n KPP is using the WRF conform integrator routine: \n %s/int/WRF_conform/%s \n", Home, integrator );
-    IncludeCode( "%s/int/WRF_conform/%s", Home, integrator ); } 
+    IncludeCode( "%s/int/WRF_conform/%s", Home, integrator );
+    if ( useBlockCells )
+      IncludeCode( "%s/int/WRF_conform/%s_blk", Home, integrator ); } 
     else
     IncludeCode( "%s/int/%s", Home, integrator );  
   
@@ -2460,6 +2562,9 @@ int j,dummy_species;
   DeclareConstant( NFIXST,  ascii( FixStartNr ) ); 
   DeclareConstant( NONZERO, ascii( max(Jac_NZ, 1) ) );
   DeclareConstant( LU_NONZERO, ascii( max(LU_Jac_NZ, 1) ) );
+  if ( useBlockCells ) { 
+        DeclareConstant( NBLOCK,  ascii( useBlockCells ) );
+  }	
   DeclareConstant( CNVAR,   ascii( VarNr+1 ) );
   if ( useStoicmat ) { 
         DeclareConstant( CNEQN,   ascii( EqnNr+1 ) );
@@ -3481,6 +3586,12 @@ int n;
  
  GenerateBlas();
 
+  if ( useWRFConform && useBlockCells ) {
+    printf("\nKPP is generating the block routines (%d cells):", useBlockCells);
+    printf("\n    - %s_Integrator",rootFileName);
+    GenerateBlockRoutines();
+  }
+
   if( useHessian ) { 
     printf("\nKPP is generating the Hessian:");
     printf("\n    - %s_Hessian\n    - %s_HessianSP",rootFileName,rootFileName);
@@ -74,7 +74,7 @@
 %token LMPCOLON LMPPLUS SPCPLUS SPCEQUAL ATOMDECL CHECK CHECKALL REORDER
 %token MEX DUMMYINDEX EQNTAGS 
 %token LOOKAT LOOKATALL TRANSPORT TRANSPORTALL MONITOR USES SPARSEDATA 
-%token WRFCONFORM
+%token WRFCONFORM BLOCKCELLS
 %token WRITE_ATM WRITE_SPC WRITE_MAT WRITE_OPT INITIALIZE XGRID YGRID ZGRID
 %token USE LANGUAGE INTFILE DRIVER RUN INLINE ENDINLINE 
 %token      PARAMETER SPCSPC INISPC INIVALUE EQNSPC EQNSIGN EQNCOEF
@@ -197,6 +197,9 @@ section	        : JACOBIAN PARAMETER
                 | WRFCONFORM
                   { WRFConform(); 
                   }
+                | BLOCKCELLS PARAMETER
+                  { CmdBlockCells( $2 );
+                  }
                 ;  
 semicolon       : semicolon ';'
                   { ScanWarning("Unnecessary ';'");
@@ -105,6 +105,7 @@ int useEqntags     = 0;
 int useLang        = F77_LANG;
 int useStochastic  = 0;
 int useWRFConform  = 0;
+int useBlockCells  = 0;
 
 
 char integrator[ MAX_PATH ] = "none";
@@ -911,3 +912,15 @@ void WRFConform()
   useWRFConform = 1;
 printf("\nKPP was told to generate WRF conform code");
 }
+
+void CmdBlockCells( char *cmd )
+{
+int n;
+char c;
+
+  if( sscanf( cmd, "%d%c", &n, &c ) == 1 && n > 0 ) {
+    useBlockCells = n;
+    return;
+  }
+  ScanError("'%s': Number of cells for #BLOCKCELLS must be a positive integer", cmd );
+}
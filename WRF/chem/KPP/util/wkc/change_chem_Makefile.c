@@ -82,7 +82,7 @@ knode_t * p1, * p2, * pm1;
                   fprintf(t_Makefile, "module_kpp_%s_Update_Rconst.o:  module_kpp_%s_Parameters.o   \n\n",kname, kname );
                   fprintf(t_Makefile, "module_kpp_%s_Jacobian.o:  module_kpp_%s_Parameters.o module_kpp_%s_JacobianSP.o   \n\n",kname, kname, kname );
                   fprintf(t_Makefile, "module_kpp_%s_Integr.o: module_kpp_%s_Parameters.o module_kpp_%s_Jacobian.o module_kpp_%s_JacobianSP.o  module_kpp_%s_Update_Rconst.o  module_wkppc_constants.o  \n\n",kname, kname, kname, kname, kname );
-                  fprintf(t_Makefile, "module_kpp_%s_interface.o: module_kpp_%s_Parameters.o module_kpp_%s_Precision.o module_kpp_%s_Integr.o  module_kpp_%s_Update_Rconst.o  module_wkppc_constants.o  \n\n",kname, kname, kname, kname, kname );
+                  fprintf(t_Makefile, "module_kpp_%s_interface.o: module_kpp_%s_Parameters.o module_kpp_%s_Precision.o module_kpp_%s_Integr.o  module_kpp_%s_Update_Rconst.o  module_wkppc_constants.o  module_chem_balance.o  \n\n",kname, kname, kname, kname, kname );
 
                }
           }
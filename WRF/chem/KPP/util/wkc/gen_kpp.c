@@ -136,6 +136,9 @@ gen_kpp ( char * inc_dirname, char * kpp_dirname )
       if ( DEBUGR == 1 )   printf("next: gen_call_to_kpp_mechanism_driver (writing inc/call_to_kpp_mech_drive.inc) \n");
      gen_kpp_call_to_mech_dr ( );
 
+      if ( DEBUGR == 1 )   printf("next: gen_kpp_balance_incs (writing inc/kpp_balance_*.inc and inc/call_to_kpp_mech_drive_guest.inc) \n");
+     gen_kpp_balance_incs ( );
+
 
      /* write arguments for call to KPPs Update_Rconst      */
           if ( DEBUGR == 1 )   printf("next: gen_kpp_args_to_Update_Rconst (writing inc/args_to_update_rconst.inc and inc/<decls_update_rconst.inc) \n");
@@ -261,7 +261,8 @@ wki_start_loop( FILE * ofile )
 
    fprintf(ofile,"\n    DO j=jts, jte\n");
    fprintf(ofile,"    DO k=kts, kte\n");
-   fprintf(ofile,"    DO i=its, ite\n\n\n");
+   fprintf(ofile,"    DO i=its, ite\n\n");
+   fprintf(ofile,"    IF ( chem_balance_skip(i,j) ) CYCLE\n\n\n");
 }
 
 int
@@ -274,6 +275,89 @@ wki_end_loop( FILE * ofile )
 }
 
 
+/* block integration (#BLOCKCELLS): cells are collected in the *_blk arrays
+   and integrated NBLOCK at a time; i,k,j are set from the loop counters
+   for the per-cell code and reset from iblk,kblk,jblk when results are
+   copied back  */
+
+int 
+decl_misc_blk (  FILE * ofile )
+{
+
+ fprintf(ofile,"    INTEGER :: i_blk, j_blk, k_blk, nblk, n_blk \n");
+ fprintf(ofile,"    INTEGER, DIMENSION(NBLOCK) :: iblk, jblk, kblk \n");
+ fprintf(ofile,"    REAL(KIND=dp), DIMENSION(NBLOCK) :: oconv_blk \n");
+ fprintf(ofile,"    REAL(KIND=dp), DIMENSION(NBLOCK,NVAR) :: var_blk \n");
+ fprintf(ofile,"    REAL(KIND=dp), DIMENSION(NBLOCK,NFIX) :: fix_blk \n");
+ fprintf(ofile,"    REAL(KIND=dp), DIMENSION(NBLOCK,NREACT) :: rconst_blk, irr_blk \n");
+
+ fprintf(ofile," \n\n\n\n ");
+}
+
+int
+wki_start_loop_blk( FILE * ofile )
+{
+
+   fprintf(ofile,"\n    nblk = 0\n");
+   fprintf(ofile,"\n    DO j_blk=jts, jte\n");
+   fprintf(ofile,"    DO k_blk=kts, kte\n");
+   fprintf(ofile,"    DO i_blk=its, ite\n\n");
+   fprintf(ofile,"    IF ( chem_balance_skip(i_blk,j_blk) .AND. .NOT. &\n");
+   fprintf(ofile,"         ( i_blk == ite .AND. k_blk == kte .AND. j_blk == jte ) ) CYCLE\n\n");
+   fprintf(ofile,"    i = i_blk\n");
+   fprintf(ofile,"    k = k_blk\n");
+   fprintf(ofile,"    j = j_blk\n\n\n");
+}
+
+int
+wki_blk_gather( FILE * ofile )
+{
+
+   fprintf(ofile,"\n      ! add cell to block (the last cell of the tile only flushes\n");
+   fprintf(ofile,"      ! the block if its column is integrated on another task)\n");
+   fprintf(ofile,"    IF ( .NOT. chem_balance_skip(i,j) ) THEN\n");
+   fprintf(ofile,"    nblk = nblk + 1\n");
+   fprintf(ofile,"    iblk(nblk) = i\n");
+   fprintf(ofile,"    kblk(nblk) = k\n");
+   fprintf(ofile,"    jblk(nblk) = j\n");
+   fprintf(ofile,"    oconv_blk(nblk) = oconv\n");
+   fprintf(ofile,"    var_blk(nblk,:) = var(:)\n");
+   fprintf(ofile,"    fix_blk(nblk,:) = fix(:)\n");
+   fprintf(ofile,"    rconst_blk(nblk,:) = RCONST(:)\n");
+   fprintf(ofile,"    irr_blk(nblk,:) = IRR_WRK(:)\n");
+   fprintf(ofile,"    END IF\n\n");
+
+   fprintf(ofile,"      ! integrate once the block is full or the tile is done\n");
+   fprintf(ofile,"    IF ( nblk > 0 .AND. ( nblk == NBLOCK .OR. &\n");
+   fprintf(ofile,"         ( i_blk == ite .AND. k_blk == kte .AND. j_blk == jte ) ) ) THEN\n");
+}
+
+int
+wki_blk_scatter_start( FILE * ofile )
+{
+
+   fprintf(ofile,"    DO n_blk = 1, nblk\n\n");
+   fprintf(ofile,"    i = iblk(n_blk)\n");
+   fprintf(ofile,"    k = kblk(n_blk)\n");
+   fprintf(ofile,"    j = jblk(n_blk)\n");
+   fprintf(ofile,"    oconv = oconv_blk(n_blk)\n");
+   fprintf(ofile,"    var(:) = var_blk(n_blk,:)\n");
+   fprintf(ofile,"    fix(:) = fix_blk(n_blk,:)\n");
+   fprintf(ofile,"    RCONST(:) = rconst_blk(n_blk,:)\n");
+   fprintf(ofile,"    IRR_WRK(:) = irr_blk(n_blk,:)\n");
+   fprintf(ofile,"    CALL chem_balance_add_cost( i, j, ISTATUS(3) )\n\n");
+}
+
+int
+wki_blk_scatter_end( FILE * ofile )
+{
+
+   fprintf(ofile,"\n    END DO\n");
+   fprintf(ofile,"    nblk = 0\n");
+   fprintf(ofile,"    END IF\n");
+}
+
+
 int
 wki_prelim( FILE * ofile )
 {
@@ -45,7 +45,8 @@ int  is_driver;
     fprintf(kpp_if,"  USE %s_UpdateRconstWRF\n",p2->name );
     fprintf(kpp_if,"  USE %s_Integrator\n\n",p2->name );
 
-    fprintf(kpp_if,"  USE module_wkppc_constants\n\n" );
+    fprintf(kpp_if,"  USE module_wkppc_constants\n" );
+    fprintf(kpp_if,"  USE module_chem_balance, ONLY : chem_balance_skip, chem_balance_add_cost\n\n" );
     if( !strcmp( p2->name,"mozcart" ) || !strcmp( p2->name,"t1_mozcart" ) 
         || !strcmp( p2->name,"mozart_mosaic_4bin" ) || !strcmp( p2->name,"mozart_mosaic_4bin_aq" ) ) 
       fprintf(kpp_if,"  USE module_irr_diag\n" );
@@ -86,6 +87,7 @@ int  is_driver;
 
      /* declare misc variables (esp. for kpp) */
       decl_misc ( kpp_if );
+      if ( p1->block_cells > 0 ) decl_misc_blk ( kpp_if );
 
   
    fprintf(kpp_if,"\n#include <kpp_mechd_l_%s.inc> \n\n\n",p2->name );
@@ -104,7 +106,10 @@ int  is_driver;
       fprintf(kpp_if,"\n#include <kpp_mechd_b_%s.inc> \n\n\n",p2->name );
    
        /* start loop over 3-D fields */
-       wki_start_loop ( kpp_if );
+       if ( p1->block_cells > 0 ) 
+         wki_start_loop_blk ( kpp_if );
+       else
+         wki_start_loop ( kpp_if );
 
 
        /* 1-D water and 3rd body concentrations, temperature  */
@@ -134,9 +139,26 @@ int  is_driver;
 
         fprintf(kpp_if,"\n#include <kpp_mechd_ib_%s.inc> \n\n",p2->name );
 
+       if ( p1->block_cells > 0 ) {
+
+            wki_blk_gather ( kpp_if );
+
+            fprintf(kpp_if, "\n  CALL %s_INTEGRATE_BLK(TIME_START, TIME_END, nblk, &  \n", p2->name );
+            fprintf(kpp_if, "          fix_blk, var_blk,  rconst_blk, ATOL, RTOL, irr_blk, & \n");
+            fprintf(kpp_if, "          ICNTRL_U=icntrl, RCNTRL_U=rcntrl, ISTATUS_U=istatus  )\n\n");
+
+            wki_blk_scatter_start ( kpp_if );
+
+       } else {
+
             fprintf(kpp_if, "\n\n\n\n  CALL %s_INTEGRATE(TIME_START, TIME_END, &  \n", p2->name );
             fprintf(kpp_if, "          FIX, VAR,  RCONST, ATOL, RTOL, IRR_WRK, & \n");
-            fprintf(kpp_if, "          ICNTRL_U=icntrl, RCNTRL_U=rcntrl  )\n\n\n\n\n");
+            fprintf(kpp_if, "          ICNTRL_U=icntrl, RCNTRL_U=rcntrl, ISTATUS_U=istatus  )\n\n");
+
+            /* integrator steps are the column cost for chem/module_chem_balance.F */
+            fprintf(kpp_if, "  CALL chem_balance_add_cost( i, j, ISTATUS(3) )\n\n\n\n\n");
+
+       }
 
 
 	    /*            fprintf(kpp_if, "          ICNTRL_U, RCNTRL_U, ISTATUS_U, RSTATUS_U, IERR_U )\n\n\n\n\n"); */
@@ -149,6 +171,8 @@ int  is_driver;
 	    /* return values from kpp to wrf */
         gen_map_kpp_to_wrf ( kpp_if, p1 );
 
+       if ( p1->block_cells > 0 ) wki_blk_scatter_end ( kpp_if );
+
 
 
        /* end loop over 3-D fields */
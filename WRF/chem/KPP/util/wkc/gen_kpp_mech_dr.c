@@ -145,3 +145,64 @@ knode_t * p1, * p2, * p3, * p4, * pm1, * pm3, * pm4;
 
 }
 
+
+
+/* column balancing (chem/module_chem_balance.F): pack and unpack calls
+   for the radicals and jvals, and their slots in kpp_guest for the call
+   to kpp_mechanism_driver on the guest columns; same order as in
+   inc/call_to_kpp_mech_drive.inc  */
+
+int
+gen_kpp_balance_incs ( )
+{
+ knode_t * pml;
+ FILE  * kpp_pck, * kpp_upk, * kpp_gst;
+ int countit;
+ int max_per_line=4;
+
+    kpp_pck = fopen( "inc/kpp_balance_pack.inc", "w" );
+    kpp_upk = fopen( "inc/kpp_balance_unpack.inc", "w" );
+    kpp_gst = fopen( "inc/call_to_kpp_mech_drive_guest.inc", "w" );
+
+      gen_kpp_warning(kpp_pck, "tools/gen_kpp_mech_dr.c","!" );
+      gen_kpp_warning(kpp_upk, "tools/gen_kpp_mech_dr.c","!" );
+      gen_kpp_warning(kpp_gst, "tools/gen_kpp_mech_dr.c","!" );
+
+
+    /* radicals are changed by KPP and sent back */
+    for ( pml = WRFC_radicals -> members;  pml != NULL ; pml = pml->next ) {
+      fprintf(kpp_pck,"      CALL chem_balance_pack( grid%%%s, .true. )\n", pml->name);
+      fprintf(kpp_upk,"      CALL chem_balance_unpack( grid%%%s )\n", pml->name);
+    }
+
+    for ( pml = WRFC_jvals -> members;  pml != NULL ; pml = pml->next ) {
+      fprintf(kpp_pck,"      CALL chem_balance_pack( grid%%%s, .false. )\n", pml->name);
+    }
+
+
+    fprintf(kpp_gst,"            ");
+    countit=0;
+    for ( pml = WRFC_radicals -> members;  pml != NULL ; pml = pml->next ) {
+      countit = countit+1;
+      fprintf(kpp_gst," kpp_guest(:,:,gs_kpp+%i),", countit);
+      if ( countit % max_per_line ==  0) {
+        fprintf(kpp_gst," & \n            ");
+      }
+    }
+    for ( pml = WRFC_jvals -> members;  pml != NULL ; pml = pml->next ) {
+      countit = countit+1;
+      fprintf(kpp_gst," kpp_guest(:,:,gs_kpp+%i),", countit);
+      if ( countit % max_per_line ==  0) {
+        fprintf(kpp_gst," & \n            ");
+      }
+    }
+    if ( countit % max_per_line !=  0) {
+      fprintf(kpp_gst,"  & \n");
+    }
+
+
+    fclose(kpp_pck);
+    fclose(kpp_upk);
+    fclose(kpp_gst);
+
+}
@@ -147,6 +147,12 @@ int   in_comment, got_it;
 	 
 
 	 fclose(spcFile);
+
+
+         /* mechanisms generated with #BLOCKCELLS are integrated block-wise */
+         q->block_cells = get_kpp_block_cells( kpp_dirname, entry->d_name );
+         if ( q->block_cells > 0 )
+           printf(" %s: integrating blocks of %i cells \n", q->name, q->block_cells );
   
     }
 
@@ -155,3 +161,28 @@ int   in_comment, got_it;
   return(0) ;
 }
 
+
+/* number of cells per block set by #BLOCKCELLS in the mechanism's .kpp file */
+int
+get_kpp_block_cells ( char* kpp_dirname, char* mech )
+{
+char kppfilename[NAMELEN], inln[NAMELEN];
+FILE * kppFile;
+int  ncells = 0;
+
+      sprintf(  kppfilename, "%s/%s/%s.kpp", kpp_dirname, mech, mech);
+
+      kppFile = fopen (kppfilename, "r" );
+      if ( kppFile == NULL ) return(0);
+
+	 while ( fgets ( inln , NAMELEN , kppFile ) != NULL ){
+           if ( !strncmp( inln, "#BLOCKCELLS", 11 ) ) {
+             if ( sscanf( inln+11, "%i", &ncells ) != 1 || ncells < 0 ) ncells = 0;
+           }
+         }
+
+      fclose(kppFile);
+
+  return(ncells) ;
+}
+
@@ -34,6 +34,9 @@ typedef struct knode_struct {
   /* flag if CO2 is found in .spc file */
   int got_co2 ;
 
+  /* cells per block if #BLOCKCELLS is set in .kpp file, 0 otherwise */
+  int block_cells ;
+
 } knode_t ;
 
 #ifndef DEFINE_GLOBALS
@@ -12,6 +12,7 @@ int get_wrf_radicals ( ) ;
 int get_wrf_jvals ( );
 
 int get_kpp_chem_specs (  char * kpp_dirname ) ;
+int get_kpp_block_cells ( char * kpp_dirname, char * mech ) ;
 
 
 int compare_kpp_to_species  ( char * kpp_dirname) ;
@@ -23,6 +24,7 @@ int change_chem_Makefile( );
 
 int gen_kpp_mechanism_driver ( );
 int gen_kpp_call_to_mech_dr ( );
+int gen_kpp_balance_incs ( );
 int gen_kpp_args_to_Update_Rconst ( );
 int gen_kpp_interface( );
 
@@ -58,6 +60,11 @@ int gen_kpp_pdecl( FILE * ofile, knode_t * nl  );
 int wki_prelim( FILE * ofile );
 int wki_start_loop( FILE * ofile );
 int wki_end_loop( FILE * ofile );
+int decl_misc_blk (  FILE * ofile );
+int wki_start_loop_blk( FILE * ofile );
+int wki_blk_gather( FILE * ofile );
+int wki_blk_scatter_start( FILE * ofile );
+int wki_blk_scatter_end( FILE * ofile );
 int wki_one_d_vars ( FILE * ofile, knode_t * pp );
 
 #define PROTOS_H_KPP
@@ -42,7 +42,7 @@ INTEGER ,       INTENT(OUT) :: Status
 INTEGER                     :: len_of_str
 LOGICAL                     :: for_out
 INTEGER, EXTERNAL           :: use_package
-LOGICAL, EXTERNAL           :: wrf_dm_on_monitor, multi_files, use_output_servers_for
+LOGICAL, EXTERNAL           :: wrf_dm_on_monitor, multi_files, use_output_servers_for`'ifelse($1,put,`, par_files')
 INTEGER                     :: locCount
 INTEGER                     :: io_form
 INTEGER                     :: Hndl
@@ -60,7 +60,7 @@ IF ( Hndl .GT. -1 ) THEN
     SELECT CASE ( use_package( io_form ) )
 #ifdef NETCDF
       CASE ( IO_NETCDF   )
-        IF ( multi_files(io_form) .OR.  wrf_dm_on_monitor() ) THEN
+        IF ( multi_files(io_form) .OR. ifelse($1,put,`( for_out .AND. par_files(io_form) ) .OR. ')wrf_dm_on_monitor() ) THEN
 ifelse($3,real,
 `#  if ( RWORDSIZE == DWORDSIZE )
            CALL ext_ncd_$1_$2_$6_double$4 ( Hndl, Element, ifelse($6,td,`DateStr,') ifelse($2,var,`Varname,') Data, &
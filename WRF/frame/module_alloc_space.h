@@ -11,6 +11,7 @@
       USE module_configure, ONLY : model_config_rec, grid_config_rec_type, in_use_for_config, model_to_grid_config_rec
 !      USE module_state_description
       USE module_scalar_tables ! this includes module_state_description too
+      USE module_alloc_report, ONLY : add_alloc_stat
 
       IMPLICIT NONE
 
@@ -52,6 +53,9 @@
       !declare ierr variable for error checking ALLOCATE calls
       INTEGER ierr
 
+      ! bytes of the array being allocated, for the alloc_report statistics
+      INTEGER(KIND=8) nbytes
+
       INTEGER                              :: loop
 
    ! Local data
@@ -111,32 +111,108 @@ INT_GET_TI_HEADER_C ( char * hdrbuf, int * hdrbufsize, int * n,  /* hdrbufsize a
   return(0) ;
 }
 
-#define MAX_FLDS 2000
-static char fld_name[MAX_FLDS][256] ;
-static char *fld_cache[MAX_FLDS] ;
-static int fld_curs[MAX_FLDS] ;
-static int fld_bufsize[MAX_FLDS] ;
+/* Field table used by the quilt servers to assemble patches.  Fields are
+   kept in arrival order in fld[] (retrieve hands them back in that order)
+   and indexed by name through a chained hash table, so lookups do not scan
+   the table.  The table grows as needed; there is no fixed field limit.
+   The patch buffers are not freed between output times: a slot keeps its
+   buffer and reuses it when the next frame puts a field of the same or
+   smaller size there, which is the usual case since history streams send
+   the same fields in the same order every time. */
+
+#define FLD_NAME_LEN 256
+#define FLD_HASH_INIT 1024   /* initial number of hash buckets, power of 2 */
+
+typedef struct {
+  char   name[FLD_NAME_LEN] ;
+  char * cache ;      /* pooled buffer, capacity bytes, kept across frames */
+  int    capacity ;
+  int    curs ;
+  int    bufsize ;
+  int    next ;       /* next slot in the same hash bucket, -1 ends chain */
+} fld_entry ;
+
+static fld_entry * flds = NULL ;
+static int maxflds  = 0 ;
+static int * fld_hash = NULL ;
+static int nbuckets = 0 ;
 static int fld     = 0 ;
 static int numflds = 0 ;
-static int frst = 1 ;
 
-int INIT_STORE_PIECE_OF_FIELD ()
+static unsigned int
+fld_hash_name ( const char * vname )
+{
+  unsigned int h = 2166136261u ;   /* FNV-1a */
+  while ( *vname ) { h ^= (unsigned char) *vname++ ; h *= 16777619u ; }
+  return( h ) ;
+}
+
+static void
+fld_hash_reset ( int nb )
 {
   int i ;
-  if ( frst ) {
-    for ( i = 0 ; i < MAX_FLDS ; i++ ) {
-      fld_cache[i] = NULL ;
+  if ( nb != nbuckets ) {
+    free( fld_hash ) ;
+    fld_hash = (int *) malloc( nb * sizeof(int) ) ;
+    nbuckets = nb ;
+  }
+  for ( i = 0 ; i < nbuckets ; i++ ) fld_hash[i] = -1 ;
+}
+
+static void
+fld_hash_insert ( int slot )
+{
+  unsigned int b = fld_hash_name( flds[slot].name ) & ( nbuckets - 1 ) ;
+  flds[slot].next = fld_hash[b] ;
+  fld_hash[b] = slot ;
+}
+
+static int
+fld_lookup ( const char * vname )
+{
+  int i ;
+  if ( nbuckets == 0 ) return( -1 ) ;
+  for ( i = fld_hash[ fld_hash_name( vname ) & ( nbuckets - 1 ) ] ; i != -1 ; i = flds[i].next ) {
+    if ( !strcmp( flds[i].name, vname ) ) return( i ) ;
+  }
+  return( -1 ) ;
+}
+
+/* append a new field; grows the slot array and keeps the load factor of
+   the hash table at or below one half */
+static int
+fld_add ( const char * vname )
+{
+  int i, n ;
+  if ( numflds == maxflds ) {
+    n = ( maxflds == 0 ) ? FLD_HASH_INIT / 2 : 2 * maxflds ;
+    flds = (fld_entry *) realloc( flds, n * sizeof(fld_entry) ) ;
+    if ( flds == NULL ) {
+#ifndef MS_SUA
+      fprintf(stderr,"frame/pack_utils.c: cannot grow field table to %d entries\n", n ) ;
+#endif
+      exit(2) ;
     }
-    frst = 0 ; 
+    for ( i = maxflds ; i < n ; i++ ) { flds[i].cache = NULL ; flds[i].capacity = 0 ; }
+    maxflds = n ;
   }
-  numflds = 0 ;
-  for ( i = 0 ; i < MAX_FLDS ; i++ ) {
-    strcpy( fld_name[i], "" ) ;
-    if ( fld_cache[i] != NULL ) free( fld_cache[i] ) ;
-    fld_cache[i] = NULL ;
-    fld_curs[i] = 0 ;
-    fld_bufsize[i] = 0 ;
+  if ( 2 * ( numflds + 1 ) > nbuckets ) {
+    fld_hash_reset( ( nbuckets == 0 ) ? FLD_HASH_INIT : 2 * nbuckets ) ;
+    for ( i = 0 ; i < numflds ; i++ ) fld_hash_insert( i ) ;
   }
+  n = numflds++ ;
+  strncpy( flds[n].name, vname, FLD_NAME_LEN-1 ) ;
+  flds[n].name[FLD_NAME_LEN-1] = '\0' ;
+  flds[n].curs = 0 ;
+  flds[n].bufsize = 0 ;
+  fld_hash_insert( n ) ;
+  return( n ) ;
+}
+
+int INIT_STORE_PIECE_OF_FIELD ()
+{
+  numflds = 0 ;
+  if ( nbuckets > 0 ) fld_hash_reset( nbuckets ) ;
   return(0) ;
 }
 
@@ -151,25 +227,18 @@ ADD_TO_BUFSIZE_FOR_FIELD_C ( int varname[], int * chunksize )
 {
   int i, n ;
   int found ;
-  char vname[256] ;
+  char vname[FLD_NAME_LEN] ;
 
   n = varname[0] ;
   for ( i = 1; i <= n ; i++ ) { vname[i-1] = varname[i] ; }
   vname[n] = '\0' ;
 
-  found = -1 ;
-  for ( i = 0 ; i < numflds ; i++ ) { if ( !strcmp( fld_name[i], vname ) ) { found = i ; break ; } }
+  found = fld_lookup( vname ) ;
   if ( found == -1 ) {
-    found = numflds++ ;
-    strcpy( fld_name[found], vname ) ;
-    fld_bufsize[found] = *chunksize ;
-  }
-  else
-  {
-    fld_bufsize[found] += *chunksize ;
+    found = fld_add( vname ) ;
   }
-  if ( fld_cache[found] != NULL ) { free( fld_cache[found] ) ; }
-  fld_cache[found] = NULL ;
+  flds[found].bufsize += *chunksize ;
+  flds[found].curs = 0 ;
   return(0) ;
 }
 
@@ -178,14 +247,13 @@ STORE_PIECE_OF_FIELD_C ( char * buf , int varname[], int * chunksize, int *retva
 {
   int i, n ;
   int found ;
-  char vname[256] ;
+  char vname[FLD_NAME_LEN] ;
 
   n = varname[0] ;
   for ( i = 1; i <= n ; i++ ) { vname[i-1] = varname[i] ; }
   vname[n] = '\0' ;
 
-  found = -1 ;
-  for ( i = 0 ; i < numflds ; i++ ) { if ( !strcmp( fld_name[i], vname ) ) { found = i ; break ; } }
+  found = fld_lookup( vname ) ;
   if ( found == -1 ) { 
 #ifndef MS_SUA
     fprintf(stderr,"frame/pack_utils.c: field (%s) not found; was not set up with add_to_bufsize_for_field\n",vname ) ;
@@ -194,22 +262,24 @@ STORE_PIECE_OF_FIELD_C ( char * buf , int varname[], int * chunksize, int *retva
     return(0)  ;
   }
 
-  if ( fld_cache[found] == NULL ) {
-     fld_cache[found] = (char *) malloc( fld_bufsize[found] ) ;
-     fld_curs[found] = 0 ;
+  if ( flds[found].capacity < flds[found].bufsize ) {
+     free( flds[found].cache ) ;
+     flds[found].cache = (char *) malloc( flds[found].bufsize ) ;
+     flds[found].capacity = ( flds[found].cache != NULL ) ? flds[found].bufsize : 0 ;
   }
 
-  if ( fld_curs[found] + *chunksize > fld_bufsize[found] ) {
+  if ( flds[found].curs + *chunksize > flds[found].capacity ||
+       flds[found].curs + *chunksize > flds[found].bufsize ) {
 #ifndef MS_SUA
     fprintf(stderr,
-"frame/pack_utils.c: %s would overwrite %d + %d  > %d [%d]\n",vname, fld_curs[found], *chunksize, fld_bufsize[found], found ) ;
+"frame/pack_utils.c: %s would overwrite %d + %d  > %d [%d]\n",vname, flds[found].curs, *chunksize, flds[found].bufsize, found ) ;
 #endif
     *retval = 1 ;
     return(0)  ;
   }
 
-  bcopy( buf, fld_cache[found]+fld_curs[found], *chunksize ) ;
-  fld_curs[found] += *chunksize ;
+  bcopy( buf, flds[found].cache+flds[found].curs, *chunksize ) ;
+  flds[found].curs += *chunksize ;
   *retval = 0 ;
   return(0) ;
 }
@@ -217,28 +287,27 @@ STORE_PIECE_OF_FIELD_C ( char * buf , int varname[], int * chunksize, int *retva
 int
 RETRIEVE_PIECES_OF_FIELD_C ( char * buf , int varname[], int * insize, int * outsize, int *retval )
 {
-  int i, n ;
-  int found ;
-  char vname[256] ;
+  int i ;
 
   if ( fld < numflds ) {
 #ifndef MS_SUA
-    if ( fld_curs[fld] > *insize ) {
-      fprintf(stderr,"retrieve: fld_curs[%d] (%d) > *insize (%d)\n",fld,fld_curs[fld], *insize ) ;
+    if ( flds[fld].curs > *insize ) {
+      fprintf(stderr,"retrieve: fld_curs[%d] (%d) > *insize (%d)\n",fld,flds[fld].curs, *insize ) ;
     }
 #endif
-    *outsize = ( fld_curs[fld] <= *insize ) ? fld_curs[fld] : *insize ;
-    bcopy( fld_cache[fld], buf, *outsize ) ;
-    varname[0] = (int) strlen( fld_name[fld] ) ;
-    for ( i = 1 ; i <= varname[0] ; i++ ) varname[i] = fld_name[fld][i-1] ;
-    if ( fld_cache[fld] != NULL ) free ( fld_cache[fld] ) ;
-    fld_cache[fld] = NULL ;
-    fld_bufsize[fld] = 0 ;
+    *outsize = ( flds[fld].curs <= *insize ) ? flds[fld].curs : *insize ;
+    if ( *outsize > 0 ) bcopy( flds[fld].cache, buf, *outsize ) ;
+    varname[0] = (int) strlen( flds[fld].name ) ;
+    for ( i = 1 ; i <= varname[0] ; i++ ) varname[i] = flds[fld].name[i-1] ;
+    /* the buffer stays with the slot for the next output time */
+    flds[fld].bufsize = 0 ;
+    flds[fld].curs = 0 ;
     fld++ ;
     *retval = 0 ;
   }
   else {
     numflds = 0 ;
+    if ( nbuckets > 0 ) fld_hash_reset( nbuckets ) ;
     *retval = -1 ;
   }
   return(0) ;
@@ -0,0 +1,101 @@
+/* wrf_file_prefetch: ask the operating system to start reading, in the
+   background, the part of a classic netCDF file that holds a given
+   record (time level) of the unlimited dimension.
+
+   The lateral boundary file is read one time level per boundary
+   interval, and every task waits while the monitor task reads it.
+   Calling wrf_file_prefetch for record N+1 right after record N has
+   been read lets the kernel bring those bytes into the page cache
+   while the model integrates, so the next read at the boundary
+   interval is served from memory.
+
+   In a classic (CDF-1, CDF-2 or CDF-5) file all record variables of
+   one record are stored together and every record has the same size,
+   so the byte range of a record can be estimated from the file size
+   and the record count kept in the header.  The range is widened to
+   two records to cover the header size that the estimate ignores.
+   Other formats (netCDF-4/HDF5, WRF binary) are left alone.
+
+   Fortran usage:
+      CALL wrf_file_prefetch( LEN_TRIM(fname), fname, irec, ierr )
+   where irec is the 0-based record to prefetch.  ierr is 0 if a hint
+   was given, 1 if the file is not classic netCDF or irec is beyond the
+   last record, and -1 if the file could not be opened.  The call never
+   blocks on the read itself.
+*/
+
+#ifndef _XOPEN_SOURCE
+# define _XOPEN_SOURCE 600
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef CRAY
+# ifdef NOUNDERSCORE
+#  define WRF_FILE_PREFETCH wrf_file_prefetch
+# else
+#   ifdef F2CSTYLE
+#  define WRF_FILE_PREFETCH wrf_file_prefetch__
+#   else
+#  define WRF_FILE_PREFETCH wrf_file_prefetch_
+#   endif
+# endif
+#endif
+
+#define PREFETCH_NAMELEN 1024
+
+void
+WRF_FILE_PREFETCH ( len , fname , irec , ierr )
+  int * len ;
+  char * fname ;
+  int * irec ;
+  int * ierr ;
+{
+  char path[PREFETCH_NAMELEN] ;
+  unsigned char hdr[12] ;
+  struct stat sb ;
+  long long numrecs, recsize, offset ;
+  int n, fd ;
+
+  *ierr = -1 ;
+  n = ( *len < PREFETCH_NAMELEN-1 ) ? *len : PREFETCH_NAMELEN-1 ;
+  strncpy( path, fname, n ) ;
+  path[n] = '\0' ;
+
+  if ( ( fd = open( path, O_RDONLY ) ) < 0 ) return ;
+  *ierr = 1 ;
+  if ( fstat( fd, &sb ) != 0 || read( fd, hdr, 12 ) != 12 ||
+       hdr[0] != 'C' || hdr[1] != 'D' || hdr[2] != 'F' )
+  {
+    close( fd ) ;
+    return ;
+  }
+
+  /* numrecs is a big-endian 4-byte integer after the magic number
+     ('CDF\001', 'CDF\002'), and an 8-byte one for 'CDF\005' */
+  numrecs = 0 ;
+  if ( hdr[3] == 1 || hdr[3] == 2 )
+  {
+    for ( n = 4 ; n < 8 ; n++ ) numrecs = ( numrecs << 8 ) | hdr[n] ;
+  }
+  else if ( hdr[3] == 5 )
+  {
+    for ( n = 4 ; n < 12 ; n++ ) numrecs = ( numrecs << 8 ) | hdr[n] ;
+  }
+  if ( numrecs <= 0 || *irec < 0 || *irec >= numrecs )
+  {
+    close( fd ) ;
+    return ;
+  }
+
+  recsize = (long long) sb.st_size / numrecs ;
+  offset  = recsize * (long long) (*irec) ;
+#if defined(POSIX_FADV_WILLNEED)
+  if ( posix_fadvise( fd, (off_t) offset, (off_t) ( 2 * recsize ), POSIX_FADV_WILLNEED ) == 0 ) *ierr = 0 ;
+#endif
+  close( fd ) ;
+}
@@ -86,6 +86,7 @@ gen_alloc2 ( FILE * fp , char * structname , char * structname2 , node_t * node,
   char x[NAMELEN] ;
   char x2[NAMELEN], fname2[NAMELEN] ;
   char dimname[3][NAMELEN] ;
+  char pkgname[NAMELEN] ;
   char tchar ;
   unsigned int *io_mask ;
   int nd ;
@@ -223,6 +224,7 @@ if ( tag == 1 )
         } else {
           strcpy(fname2,fname) ;
         }
+        if ( !strcmp( field_package( fname, pkgname ), "-" ) ) field_package( p->name, pkgname ) ;
 
 /* check for errors in memory allocation */
 
@@ -243,9 +245,12 @@ if ( tag == 1 )
          for ( bdy = 1 ; bdy <= 4 ; bdy++ )
          {
            if( p->type != NULL && tchar != '?' ) {
-	     fprintf(fp,"  num_bytes_allocated = num_bytes_allocated + &\n(%s) * %cWORDSIZE\n",
+	     fprintf(fp,"  nbytes = &\n(%s) * %cWORDSIZE\n",
                          array_size_expression("", "(", bdy, t2, p, post_for_count, "model_config_rec%"),
                          tchar) ;
+	     fprintf(fp,"  num_bytes_allocated = num_bytes_allocated + nbytes\n") ;
+	     fprintf(fp,"  CALL add_alloc_stat( '%s%s', '%s', nbytes )\n",
+                         fname2, bdy_indicator(bdy), pkgname) ;
            }
 	   if ( sw == 1 ) {
              fprintf(fp, "  ALLOCATE(%s%s%s%s,STAT=ierr)\n  if (ierr.ne.0) then\n    CALL wrf_error_fatal ( &\n    'frame/module_domain.f: Failed to allocate %s%s%s%s. ')\n  endif\n",
@@ -267,9 +272,11 @@ if ( tag == 1 )
          }
        } else {
          if( p->type != NULL && tchar != '?' ) {
-	   fprintf(fp,"  num_bytes_allocated = num_bytes_allocated + &\n(%s) * %cWORDSIZE\n",
+	   fprintf(fp,"  nbytes = &\n(%s) * %cWORDSIZE\n",
                    array_size_expression("", "(", -1, t2, p, post_for_count, "model_config_rec%"),
                    tchar) ;
+	   fprintf(fp,"  num_bytes_allocated = num_bytes_allocated + nbytes\n") ;
+	   fprintf(fp,"  CALL add_alloc_stat( '%s', '%s', nbytes )\n", fname2, pkgname) ;
          }
 	 if ( sw == 1 ) {
            fprintf(fp, "  ALLOCATE(%s%s%s,STAT=ierr)\n  if (ierr.ne.0) then\n    CALL wrf_error_fatal ( &\n    'frame/module_domain.f: Failed to allocate %s%s%s. ')\n  endif\n",
@@ -489,6 +496,33 @@ if ( tag == 1 )
   return(0) ;
 }
 
+/* name of the first package whose state list contains fname, or "-" */
+char *
+field_package ( char * fname , char * pkgname )
+{
+  node_t * pkg ;
+  char scalars_str[NAMELEN_LONG] ;
+  char * scalars, * c, * pos1, * pos2 ;
+
+  strcpy( pkgname, "-" ) ;
+  for ( pkg = Packages ; pkg != NULL ; pkg = pkg->next )
+  {
+    strcpy( scalars_str, pkg->pkg_4dscalars ) ;
+    for ( scalars = strtok_rentr( scalars_str, ";", &pos1 ) ; scalars != NULL ; scalars = strtok_rentr( NULL, ";", &pos1 ) )
+    {
+      if ( (c = strtok_rentr( scalars, ":", &pos2 )) == NULL || strcmp( c, "state" ) ) continue ;
+      for ( c = strtok_rentr( NULL, ",", &pos2 ) ; c != NULL ; c = strtok_rentr( NULL, ",", &pos2 ) )
+      {
+        if ( !strcasecmp( c, fname ) ) {
+          strcpy( pkgname, pkg->name ) ;
+          return( pkgname ) ;
+        }
+      }
+    }
+  }
+  return( pkgname ) ;
+}
+
 #if 0
 int
 gen_alloc_count ( char * dirname )
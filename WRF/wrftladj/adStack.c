@@ -19,22 +19,48 @@ static char adSid[]="$Id: adStack.c 3723 2011-02-24 13:34:42Z llh $";
 #      define POPREAL8ARRAY popreal8array_
 #   endif
 # endif
+# ifdef NOUNDERSCORE
+#      define ADSTACK_CONFIG adstack_config
+#      define ADSTACK_REPORT adstack_report
+# else
+#   ifdef F2CSTYLE
+#      define ADSTACK_CONFIG adstack_config__
+#      define ADSTACK_REPORT adstack_report__
+#   else
+#      define ADSTACK_CONFIG adstack_config_
+#      define ADSTACK_REPORT adstack_report_
+#   endif
+# endif
 #endif
 
+#ifndef _XOPEN_SOURCE
+# define _XOPEN_SOURCE 600
+#endif
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#ifdef ADSTACK_ZLIB
+#include <zlib.h>
+#endif
 
 #define ONE_BLOCK_SIZE 16384
 #ifndef STACK_SIZE_TRACING
 #define STACK_SIZE_TRACING 1
 #endif
 /* The main stack is a double-chain of DoubleChainedBlock objects.
- * Each DoubleChainedBlock holds an array[ONE_BLOCK_SIZE] of char. */
+ * Each DoubleChainedBlock holds an array[ONE_BLOCK_SIZE] of char.
+ * A block that has been spilled to disk (see below) has no contents;
+ * spillOffset and spillLen then locate them in the spill file. */
 typedef struct _doubleChainedBlock{
   struct _doubleChainedBlock *prev ;
   char                       *contents ;
   struct _doubleChainedBlock *next ;
+  long int                    spillOffset ;
+  unsigned int                spillLen ;
 } DoubleChainedBlock ;
 
 /* Globals that define the current position in the stack: */
@@ -50,15 +76,148 @@ static long int mmctrafficM = 0 ;
 long int bigStackSize = 0;
 #endif
 
+/* Out-of-core tape. When more than maxResident blocks are in memory,
+ * the lowest resident block is written to the spill file and its
+ * contents are freed. Since the stack only grows and shrinks at the
+ * top, the spilled blocks are always the bottom of the chain, below
+ * lowResident, and the spill file is itself used as a stack.
+ * Writes return once the data is in the page cache, so the kernel
+ * flushes them to disk while the tape keeps growing.  When the tape
+ * is popped down to lowResident, a read-ahead hint is given for the
+ * spilled blocks below it before they are needed.  maxResident = 0
+ * (the default) keeps the whole tape in memory as before. */
+static long int maxResident = 0 ;
+static long int nbResident = 0 ;
+static DoubleChainedBlock *lowResident = NULL ;
+static DoubleChainedBlock *topBlock = NULL ;
+static int      spillFd = -1 ;
+static long int spillTop = 0 ;
+static char     spillDir[1024] = "." ;
+
+/* Tape instrumentation, printed by adstack_report_ */
+static int       tapeTiming = 0 ;
+static long long tapeBytes = 0 ;
+static long long tapePeak = 0 ;
+static long long pushedBytes = 0 ;
+static long long poppedBytes = 0 ;
+static long long spillPeak = 0 ;
+static long int  nbSpilled = 0 ;
+static long int  nbReloaded = 0 ;
+static long int  residentPeak = 0 ;
+static double    pushSeconds = 0.0 ;
+static double    popSeconds = 0.0 ;
+
+static double tapeClock() {
+  struct timeval tv ;
+  gettimeofday(&tv, NULL) ;
+  return (double)tv.tv_sec + 1.0e-6*(double)tv.tv_usec ;
+}
+
+/* Writes the contents of the lowest resident block to the spill file
+ * and frees them. */
+static void spillLowest() {
+  DoubleChainedBlock *block = lowResident ;
+  char *out = block->contents ;
+  unsigned int len = ONE_BLOCK_SIZE ;
+#ifdef ADSTACK_ZLIB
+  static Bytef zbuf[ONE_BLOCK_SIZE+ONE_BLOCK_SIZE/8+64] ;
+  uLongf zlen = sizeof(zbuf) ;
+  if (compress2(zbuf, &zlen, (Bytef*)block->contents, ONE_BLOCK_SIZE, 1) == Z_OK
+      && zlen < ONE_BLOCK_SIZE) {
+    out = (char*)zbuf ;
+    len = (unsigned int)zlen ;
+  }
+#endif
+  if (spillFd < 0) {
+    char name[1100] ;
+    sprintf(name, "%s/wrf_adstack.%ld.tmp", spillDir, (long int)getpid()) ;
+    spillFd = open(name, O_RDWR|O_CREAT|O_TRUNC, 0600) ;
+    if (spillFd < 0) {
+      printf("Cannot open adjoint tape spill file %s\n", name) ;
+      exit(1) ;
+    }
+    /* the file disappears when the run ends, however it ends */
+    unlink(name) ;
+  }
+  if (pwrite(spillFd, out, len, (off_t)spillTop) != (ssize_t)len) {
+    printf("Cannot write adjoint tape spill file in %s\n", spillDir) ;
+    exit(1) ;
+  }
+  block->spillOffset = spillTop ;
+  block->spillLen = len ;
+  spillTop += len ;
+  if (spillTop > spillPeak) spillPeak = spillTop ;
+  free(block->contents) ;
+  block->contents = NULL ;
+  lowResident = block->next ;
+  nbResident-- ;
+  nbSpilled++ ;
+}
+
+/* Reads back the contents of "block", the highest spilled block, and
+ * hints the kernel to read ahead the spilled blocks below it.  Unused
+ * blocks above the top of the stack are released to keep the number
+ * of resident blocks within the limit. */
+static void reloadBlock(DoubleChainedBlock *block) {
+  char *contents = (char*)malloc(ONE_BLOCK_SIZE*sizeof(char)) ;
+  ssize_t nread ;
+  if (contents == NULL) {
+    printf("Out of memory reloading adjoint tape block\n") ;
+    exit(1) ;
+  }
+#ifdef ADSTACK_ZLIB
+  if (block->spillLen < ONE_BLOCK_SIZE) {
+    static Bytef zbuf[ONE_BLOCK_SIZE+ONE_BLOCK_SIZE/8+64] ;
+    uLongf ulen = ONE_BLOCK_SIZE ;
+    nread = pread(spillFd, zbuf, block->spillLen, (off_t)block->spillOffset) ;
+    if (nread != (ssize_t)block->spillLen ||
+        uncompress((Bytef*)contents, &ulen, zbuf, block->spillLen) != Z_OK) nread = -1 ;
+  } else
+#endif
+  nread = pread(spillFd, contents, block->spillLen, (off_t)block->spillOffset) ;
+  if (nread != (ssize_t)block->spillLen) {
+    printf("Cannot read adjoint tape spill file in %s\n", spillDir) ;
+    exit(1) ;
+  }
+  block->contents = contents ;
+  spillTop = block->spillOffset ;
+  block->spillOffset = -1 ;
+  lowResident = block ;
+  nbResident++ ;
+  nbReloaded++ ;
+#if defined(POSIX_FADV_WILLNEED)
+  if (block->prev && block->prev->contents == NULL) {
+    long int from = block->prev->spillOffset-8*ONE_BLOCK_SIZE ;
+    if (from < 0) from = 0 ;
+    posix_fadvise(spillFd, (off_t)from,
+                  (off_t)(block->prev->spillOffset+block->prev->spillLen-from),
+                  POSIX_FADV_WILLNEED) ;
+  }
+#endif
+  while (nbResident > maxResident && topBlock != curStack
+         && topBlock != lookStack && topBlock != block) {
+    DoubleChainedBlock *unused = topBlock ;
+    topBlock = unused->prev ;
+    topBlock->next = NULL ;
+    free(unused->contents) ;
+    free(unused) ;
+    nbResident-- ;
+  }
+}
+
 /* PUSHes "nbChars" consecutive chars from a location starting at address "x".
  * Resets the LOOKing position if it was active.
  * Checks that there is enough space left to hold "nbChars" chars.
  * Otherwise, allocates the necessary space. */
 void pushNarray(char *x, unsigned int nbChars) {
   unsigned int nbmax = (curStack)?ONE_BLOCK_SIZE-(curStackTop-(curStack->contents)):0 ;
+  double t0 = (tapeTiming)?tapeClock():0.0 ;
 #ifdef STACK_SIZE_TRACING
   bigStackSize += nbChars;
 #endif
+  pushedBytes += nbChars ;
+  tapeBytes += nbChars ;
+  if (tapeBytes > tapePeak) tapePeak = tapeBytes ;
 
   mmctraffic += nbChars ;
   while (mmctraffic >= 1000000) {
@@ -94,10 +253,18 @@ void pushNarray(char *x, unsigned int nbChars) {
 	newStack->prev = curStack ;
 	newStack->next = NULL ;
 	newStack->contents = contents ;
+	newStack->spillOffset = -1 ;
+	newStack->spillLen = 0 ;
 	curStack = newStack ;
+	topBlock = newStack ;
+	if (lowResident == NULL) lowResident = newStack ;
+	nbResident++ ;
+	if (nbResident > residentPeak) residentPeak = nbResident ;
         /* new block created! */
       } else
 	curStack = curStack->next ;
+      while (maxResident > 0 && nbResident > maxResident && lowResident != curStack)
+        spillLowest() ;
       inx -= ONE_BLOCK_SIZE ;
       if(inx>x)
 	memcpy(curStack->contents,inx,ONE_BLOCK_SIZE) ;
@@ -109,6 +276,7 @@ void pushNarray(char *x, unsigned int nbChars) {
       }
     }
   }
+  if (tapeTiming) pushSeconds += tapeClock()-t0 ;
 }
 
 /* POPs "nbChars" consecutive chars to a location starting at address "x".
@@ -117,9 +285,12 @@ void pushNarray(char *x, unsigned int nbChars) {
  * Otherwise, pops as many blocks as necessary. */
 void popNarray(char *x, unsigned int nbChars) {
   unsigned int nbmax = curStackTop-(curStack->contents) ;
+  double t0 = (tapeTiming)?tapeClock():0.0 ;
 #ifdef STACK_SIZE_TRACING
   bigStackSize -= nbChars;
 #endif
+  poppedBytes += nbChars ;
+  tapeBytes -= nbChars ;
   lookStack = NULL ;
   if (nbChars <= nbmax) {
     curStackTop-=nbChars ;
@@ -131,6 +302,7 @@ void popNarray(char *x, unsigned int nbChars) {
     while (x<tlx) {
       curStack = curStack->prev ;
       if (curStack==NULL) printf("Popping from an empty stack!!!") ;
+      if (curStack->contents == NULL) reloadBlock(curStack) ;
       if (x+ONE_BLOCK_SIZE<tlx) {
 	memcpy(x,curStack->contents,ONE_BLOCK_SIZE) ;
 	x += ONE_BLOCK_SIZE ;
@@ -142,6 +314,7 @@ void popNarray(char *x, unsigned int nbChars) {
       }
     }
   }
+  if (tapeTiming) popSeconds += tapeClock()-t0 ;
 }
 
 /* LOOKs "nbChars" consecutive chars to a location starting at address "x".
@@ -167,6 +340,7 @@ void lookNarray(char *x, unsigned int nbChars) {
     while (x<tlx) {
       lookStack = lookStack->prev ;
       if (lookStack==NULL) printf("Looking into an empty stack!!!") ;
+      if (lookStack->contents == NULL) reloadBlock(lookStack) ;
       if (x+ONE_BLOCK_SIZE<tlx) {
 	memcpy(x,lookStack->contents,ONE_BLOCK_SIZE) ;
 	x += ONE_BLOCK_SIZE ;
@@ -510,7 +684,7 @@ void showrecentcstack_() {
       printf("%02X,",*st1%256) ;
       totalNumChars-- ;
     }
-    while (totalNumChars>0 && stack->prev) {
+    while (totalNumChars>0 && stack->prev && stack->prev->contents) {
       printf(" || ") ;
       stack = stack->prev ;
       stackTop = (stack->contents)+ONE_BLOCK_SIZE ;
@@ -538,3 +712,36 @@ void getnbblocksinstack_(int *nbblocks) {
     (*nbblocks)++ ;
   }
 }
+
+/****** Out-of-core tape configuration and instrumentation: ******/
+
+/* Fortran usage:
+ *    CALL adstack_config( max_mb, timing, LEN_TRIM(dir), dir )
+ * keeps at most max_mb megabytes of tape in memory and spills the
+ * rest to a scratch file in directory dir (0: no limit).  timing > 0
+ * also times every push and pop for adstack_report. */
+void ADSTACK_CONFIG(int *maxMB, int *timing, int *len, char *dir) {
+  int n = (*len < (int)sizeof(spillDir)-1) ? *len : (int)sizeof(spillDir)-1 ;
+  maxResident = (*maxMB > 0) ? ((long int)*maxMB*1048576L)/ONE_BLOCK_SIZE : 0 ;
+  if (*maxMB > 0 && maxResident < 2) maxResident = 2 ;
+  tapeTiming = (*timing > 0) ;
+  if (n > 0) {
+    strncpy(spillDir, dir, n) ;
+    spillDir[n] = '\0' ;
+  }
+}
+
+/* Prints the tape high-water mark, traffic and spill statistics. */
+void ADSTACK_REPORT() {
+  printf(" Adjoint tape: peak %.1f MB, now %.1f MB, %ld blocks of %i bytes at most in memory\n",
+         tapePeak/1048576.0, tapeBytes/1048576.0, residentPeak, ONE_BLOCK_SIZE) ;
+  printf(" Adjoint tape: pushed %.1f MB, popped %.1f MB\n",
+         pushedBytes/1048576.0, poppedBytes/1048576.0) ;
+  if (maxResident > 0)
+    printf(" Adjoint tape: limit %ld blocks, %ld blocks spilled, %ld reloaded, spill file peak %.1f MB\n",
+           maxResident, nbSpilled, nbReloaded, spillPeak/1048576.0) ;
+  if (tapeTiming)
+    printf(" Adjoint tape: push %.3f s (%.1f MB/s), pop %.3f s (%.1f MB/s)\n",
+           pushSeconds, (pushSeconds > 0.0) ? pushedBytes/1048576.0/pushSeconds : 0.0,
+           popSeconds, (popSeconds > 0.0) ? poppedBytes/1048576.0/popSeconds : 0.0) ;
+}